@@ -27,6 +27,8 @@ public:
     void setChapters(const Ffmpeg::Chapters &chapters);
 #endif
     [[nodiscard]] auto sliderGlobalPos() const -> QPoint;
+    // the position slider is being dragged, seek is emitted again on release
+    [[nodiscard]] auto isSliderDown() const -> bool;
 
     void setSourceFPS(float fps);
     void setCurrentFPS(float fps);
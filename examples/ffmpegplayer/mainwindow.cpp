@@ -467,6 +467,7 @@ void MainWindow::onProcessEvents()
                 d_ptr->controlWidget->setPlayButtonChecked(false);
                 break;
             case Ffmpeg::MediaState::Opening:
+            case Ffmpeg::MediaState::Buffering:
                 d_ptr->controlWidget->setPlayButtonChecked(true);
                 break;
             case Ffmpeg::MediaState::Playing:
@@ -643,7 +644,10 @@ void MainWindow::buildConnect()
     connect(d_ptr->controlWidget, &ControlWidget::leavePosition, this, &MainWindow::onLeaveSlider);
     connect(d_ptr->controlWidget, &ControlWidget::seek, d_ptr->playerPtr.data(), [this](int value) {
         qint64 position = value;
-        d_ptr->playerPtr->addEvent(Ffmpeg::EventPtr(new Ffmpeg::SeekEvent(position * AV_TIME_BASE)));
+        auto *seekEvent = new Ffmpeg::SeekEvent(position * AV_TIME_BASE);
+        // scrubbing shows keyframes, the seek on release lands on the exact frame
+        seekEvent->setAccurate(!d_ptr->controlWidget->isSliderDown());
+        d_ptr->playerPtr->addEvent(Ffmpeg::EventPtr(seekEvent));
     });
     connect(d_ptr->controlWidget, &ControlWidget::play, this, [this](bool checked) {
         if (checked && !d_ptr->playerPtr->isRunning()) {
@@ -64,7 +64,7 @@ PreviewWidget::PreviewWidget(QWidget *parent)
 
 PreviewWidget::~PreviewWidget() = default;
 
-void PreviewWidget::setFrames(const std::vector<QSharedPointer<Ffmpeg::Frame>> &framePtrs)
+void PreviewWidget::setFrames(const std::vector<Ffmpeg::FramePtr> &framePtrs)
 {
     d_ptr->framePtrs = framePtrs;
     d_ptr->frameIndex = 2;
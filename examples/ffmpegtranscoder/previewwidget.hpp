@@ -1,14 +1,12 @@
 #ifndef PREVIEWWIDGET_HPP
 #define PREVIEWWIDGET_HPP
 
+#include <ffmpeg/frame.hpp>
+
 #include <QWidget>
 
 #include <vector>
 
-namespace Ffmpeg {
-class Frame;
-};
-
 class PreviewWidget : public QWidget
 {
     Q_OBJECT
@@ -16,7 +14,7 @@ public:
     explicit PreviewWidget(QWidget *parent = nullptr);
     ~PreviewWidget() override;
 
-    void setFrames(const std::vector<QSharedPointer<Ffmpeg::Frame>> &framePtrs);
+    void setFrames(const std::vector<Ffmpeg::FramePtr> &framePtrs);
 
 private slots:
     void onPerFrame();
@@ -7,27 +7,34 @@
 
 #include <QDebug>
 
+#include <deque>
+
 namespace Ffmpeg {
 
+static constexpr auto s_noSeekTarget = std::numeric_limits<qint64>::min();
+
 class AudioDecoder::AudioDecoderPrivate
 {
 public:
-    explicit AudioDecoderPrivate(AudioDecoder *q)
+    explicit AudioDecoderPrivate(ClockDomain *clockDomain, AudioDecoder *q)
         : q_ptr(q)
     {
-        decoderAudioFrame = new AudioDisplay(q_ptr);
+        decoderAudioFrame = new AudioDisplay(clockDomain, q_ptr);
     }
 
-    void processEvent() const
+    void processEvent()
     {
         while (q_ptr->m_runing.load() && !q_ptr->m_eventQueue.empty()) {
             auto eventPtr = q_ptr->m_eventQueue.take();
             switch (eventPtr->type()) {
-            case Event::EventType::Pause: decoderAudioFrame->addEvent(eventPtr); break;
+            case Event::EventType::Pause:
+            case Event::EventType::Buffering: decoderAudioFrame->addEvent(eventPtr); break;
             case Event::EventType::Seek: {
                 auto *seekEvent = static_cast<SeekEvent *>(eventPtr.data());
                 seekEvent->countDown();
                 q_ptr->clear();
+                framePtrs.clear();
+                seekTarget = seekEvent->isAccurate() ? seekEvent->position() : s_noSeekTarget;
                 decoderAudioFrame->addEvent(eventPtr);
             } break;
             default: break;
@@ -35,19 +42,33 @@ public:
         }
     }
 
+    // decoded frames the display queue could not take yet
+    auto flushFrames() -> bool
+    {
+        while (!framePtrs.empty()) {
+            if (!decoderAudioFrame->tryAppend(std::move(framePtrs.front()))) {
+                return false;
+            }
+            framePtrs.pop_front();
+        }
+        return true;
+    }
+
     AudioDecoder *q_ptr;
 
     AudioDisplay *decoderAudioFrame;
+    std::deque<FramePtr> framePtrs;
+    // reused by every decodeFrame call
+    std::vector<FramePtr> decodedFrames;
+    // microseconds, frames before it are dropped until the first one at or after it is decoded
+    qint64 seekTarget = s_noSeekTarget;
 };
 
-AudioDecoder::AudioDecoder(QObject *parent)
+AudioDecoder::AudioDecoder(ClockDomain *clockDomain, QObject *parent)
     : Decoder<PacketPtr>(parent)
-    , d_ptr(new AudioDecoderPrivate(this))
+    , d_ptr(new AudioDecoderPrivate(clockDomain, this))
 {
-    connect(d_ptr->decoderAudioFrame,
-            &AudioDisplay::positionChanged,
-            this,
-            &AudioDecoder::positionChanged);
+    d_ptr->decoderAudioFrame->setUpstream([this] { notify(); });
 }
 
 AudioDecoder::~AudioDecoder()
@@ -65,28 +86,46 @@ void AudioDecoder::setMasterClock()
     d_ptr->decoderAudioFrame->setMasterClock();
 }
 
-void AudioDecoder::runDecoder()
+void AudioDecoder::onDecoderStarted()
 {
+    d_ptr->seekTarget = s_noSeekTarget;
+    d_ptr->decoderAudioFrame->setUseSharedExecutor(useSharedExecutor());
+    d_ptr->decoderAudioFrame->setLowLatency(lowLatency());
     d_ptr->decoderAudioFrame->startDecoder(m_formatContext, m_contextInfo);
+}
+
+void AudioDecoder::onDecoderStopped()
+{
+    d_ptr->framePtrs.clear();
+    d_ptr->decoderAudioFrame->stopDecoder();
+}
 
-    while (m_runing) {
-        d_ptr->processEvent();
+auto AudioDecoder::runDecoderStep() -> bool
+{
+    d_ptr->processEvent();
+    if (!d_ptr->flushFrames()) {
+        return false;
+    }
 
-        auto packetPtr(m_queue.take());
-        if (packetPtr.isNull()) {
-            continue;
-        }
-        auto framePtrs = m_contextInfo->decodeFrame(packetPtr);
-        for (const auto &framePtr : framePtrs) {
-            calculatePts(framePtr.data(), m_contextInfo, m_formatContext);
-            d_ptr->decoderAudioFrame->append(framePtr);
-        }
+    PacketPtr packetPtr;
+    if (!m_queue.tryTake(packetPtr)) {
+        return false;
     }
-    while (m_runing && d_ptr->decoderAudioFrame->size() != 0) {
-        msleep(s_waitQueueEmptyMilliseconds);
+    if (packetPtr.isNull()) {
+        return true;
     }
-
-    d_ptr->decoderAudioFrame->stopDecoder();
+    d_ptr->decodedFrames.clear();
+    m_contextInfo->decodeFrame(packetPtr, d_ptr->decodedFrames, d_ptr->seekTarget);
+    if (!d_ptr->decodedFrames.empty()) {
+        d_ptr->seekTarget = s_noSeekTarget;
+    }
+    for (const auto &framePtr : d_ptr->decodedFrames) {
+        calculatePts(framePtr.data(), m_contextInfo, m_formatContext);
+        d_ptr->framePtrs.push_back(framePtr);
+    }
+    d_ptr->decodedFrames.clear();
+    d_ptr->flushFrames();
+    return true;
 }
 
 } // namespace Ffmpeg
@@ -6,22 +6,23 @@
 
 namespace Ffmpeg {
 
+class ClockDomain;
+
 class AudioDecoder : public Decoder<PacketPtr>
 {
     Q_OBJECT
 public:
-    explicit AudioDecoder(QObject *parent = nullptr);
+    explicit AudioDecoder(ClockDomain *clockDomain, QObject *parent = nullptr);
     ~AudioDecoder() override;
 
     void setVolume(qreal volume);
 
     void setMasterClock();
 
-signals:
-    void positionChanged(qint64 position); // ms
-
 protected:
-    void runDecoder() override;
+    void onDecoderStarted() override;
+    void onDecoderStopped() override;
+    auto runDecoderStep() -> bool override;
 
 private:
     class AudioDecoderPrivate;
@@ -1,12 +1,12 @@
 #include "audiodisplay.hpp"
 #include "clock.hpp"
 
+#include <audiorender/audioframequeue.hpp>
 #include <audiorender/audiooutputthread.hpp>
 #include <event/seekevent.hpp>
 #include <event/valueevent.hpp>
 
 #include <QTime>
-#include <QWaitCondition>
 
 extern "C" {
 #include <libavutil/time.h>
@@ -17,15 +17,15 @@ namespace Ffmpeg {
 class AudioDisplay::AudioDisplayPrivate
 {
 public:
-    explicit AudioDisplayPrivate(AudioDisplay *q)
+    explicit AudioDisplayPrivate(ClockDomain *clockDomain, AudioDisplay *q)
         : q_ptr(q)
     {
-        clock = new Clock(q);
+        clock = new Clock(clockDomain, q);
     }
 
     ~AudioDisplayPrivate() = default;
 
-    void processEvent(bool &firstFrame) const
+    void processEvent()
     {
         while (q_ptr->m_runing.load() && !q_ptr->m_eventQueue.empty()) {
             qDebug() << "AudioFramePrivate::processEvent";
@@ -36,8 +36,14 @@ public:
                 auto paused = pauseEvent->paused();
                 clock->setPaused(paused);
             } break;
+            case Event::EventType::Buffering: {
+                auto *bufferingEvent = static_cast<BufferingEvent *>(eventPtr.data());
+                setHolding(bufferingEvent->buffering());
+            } break;
             case Event::EventType::Seek: {
                 q_ptr->clear();
+                audioOutputThread->frameQueue()->flush();
+                framePtr.reset();
                 firstFrame = false;
             }
             default: break;
@@ -45,19 +51,45 @@ public:
         }
     }
 
+    // no frame is written and the sink is suspended, the held frame is written as much later
+    void setHolding(bool value)
+    {
+        if (holding == value) {
+            return;
+        }
+        holding = value;
+        clock->setPaused(holding);
+        auto now = av_gettime_relative();
+        if (holding) {
+            holdTime = now;
+        } else {
+            writeTime += now - holdTime;
+        }
+        if (audioOutputThreadPtr != nullptr) {
+            emit audioOutputThreadPtr->pausedChanged(holding);
+        }
+    }
+
     AudioDisplay *q_ptr;
 
     qreal volume = 0.5;
+    QScopedPointer<AudioOutputThread> audioOutputThread;
     QPointer<AudioOutputThread> audioOutputThreadPtr;
 
     Clock *clock;
-    QMutex mutex;
-    QWaitCondition waitCondition;
+
+    bool firstFrame = false;
+    quint64 dropNum = 0;
+    // frame waiting for its write time or for room in the sink queue
+    FramePtr framePtr;
+    qint64 writeTime = 0;
+    bool holding = false;
+    qint64 holdTime = 0;
 };
 
-AudioDisplay::AudioDisplay(QObject *parent)
+AudioDisplay::AudioDisplay(ClockDomain *clockDomain, QObject *parent)
     : Decoder<FramePtr>(parent)
-    , d_ptr(new AudioDisplayPrivate(this))
+    , d_ptr(new AudioDisplayPrivate(clockDomain, this))
 {}
 
 AudioDisplay::~AudioDisplay()
@@ -75,53 +107,76 @@ void AudioDisplay::setVolume(qreal volume)
 
 void AudioDisplay::setMasterClock()
 {
-    Clock::setMaster(d_ptr->clock);
+    d_ptr->clock->domain()->setMaster(d_ptr->clock);
 }
 
-void AudioDisplay::runDecoder()
+void AudioDisplay::onDecoderStarted()
 {
-    quint64 dropNum = 0;
-    QScopedPointer<AudioOutputThread> audioOutputThreadPtr(new AudioOutputThread);
-    d_ptr->audioOutputThreadPtr = audioOutputThreadPtr.data();
-    audioOutputThreadPtr->openOutput(m_contextInfo, d_ptr->volume);
-    bool firstFrame = false;
-    while (m_runing.load()) {
-        d_ptr->processEvent(firstFrame);
+    d_ptr->dropNum = 0;
+    d_ptr->firstFrame = false;
+    d_ptr->framePtr.reset();
+    d_ptr->holding = false;
+    d_ptr->audioOutputThread.reset(new AudioOutputThread);
+    d_ptr->audioOutputThreadPtr = d_ptr->audioOutputThread.data();
+    // the sink taking frames makes room for the one we hold
+    d_ptr->audioOutputThread->frameQueue()->setTakenCallback([this] { notify(); });
+    d_ptr->audioOutputThread->openOutput(m_contextInfo, d_ptr->clock, d_ptr->volume);
+}
+
+void AudioDisplay::onDecoderStopped()
+{
+    d_ptr->framePtr.reset();
+    d_ptr->audioOutputThread.reset();
+    qInfo() << "Audio Drop Num:" << d_ptr->dropNum;
+}
+
+auto AudioDisplay::runDecoderStep() -> bool
+{
+    d_ptr->processEvent();
+    if (d_ptr->holding) {
+        return false;
+    }
 
-        auto framePtr(m_queue.take());
+    if (d_ptr->framePtr.isNull()) {
+        FramePtr framePtr;
+        if (!m_queue.tryTake(framePtr)) {
+            return false;
+        }
         if (framePtr.isNull()) {
-            continue;
+            return true;
         }
-        if (!firstFrame) {
+        if (!d_ptr->firstFrame) {
             qDebug() << "Audio firstFrame: "
                      << QTime::fromMSecsSinceStartOfDay(framePtr->pts() / 1000)
                             .toString("hh:mm:ss.zzz");
-            firstFrame = true;
+            d_ptr->firstFrame = true;
             d_ptr->clock->reset(framePtr->pts());
         }
-        emit audioOutputThreadPtr->convertData(framePtr);
-        auto pts = framePtr->pts();
-        d_ptr->clock->update(pts, av_gettime_relative());
+        // the clock follows what is audible, the output device moves it as the sink plays
         qint64 delay = 0;
         if (!d_ptr->clock->getDelayWithMaster(delay)) {
-            continue;
+            return true;
         }
-        auto emitPosition = qScopeGuard([=]() { emit positionChanged(pts); });
         if (!d_ptr->clock->adjustDelay(delay)) {
             qDebug() << "Audio Delay: " << delay;
-            dropNum++;
-            continue;
-        }
-        delay /= 1000;
-        if (delay > 0) {
-            QMutexLocker locker(&d_ptr->mutex);
-            d_ptr->waitCondition.wait(&d_ptr->mutex, delay);
+            d_ptr->dropNum++;
+            return true;
         }
-        // qDebug() << "Audio PTS:"
-        //          << QTime::fromMSecsSinceStartOfDay(pts / 1000).toString("hh:mm:ss.zzz");
-        emit audioOutputThreadPtr->wirteData();
+        d_ptr->framePtr = framePtr;
+        d_ptr->writeTime = av_gettime_relative() + delay;
+    }
+
+    if (av_gettime_relative() < d_ptr->writeTime) {
+        wakeupAt(d_ptr->writeTime);
+        return false;
+    }
+    // qDebug() << "Audio PTS:"
+    //          << QTime::fromMSecsSinceStartOfDay(pts / 1000).toString("hh:mm:ss.zzz");
+    if (!d_ptr->audioOutputThread->frameQueue()->tryAppend(std::move(d_ptr->framePtr))) {
+        // the sink pulls at the device rate, it wakes us up once it took a frame
+        return false;
     }
-    qInfo() << "Audio Drop Num:" << dropNum;
+    return true;
 }
 
 } // namespace Ffmpeg
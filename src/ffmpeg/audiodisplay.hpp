@@ -6,22 +6,23 @@
 
 namespace Ffmpeg {
 
+class ClockDomain;
+
 class AudioDisplay : public Decoder<FramePtr>
 {
     Q_OBJECT
 public:
-    explicit AudioDisplay(QObject *parent = nullptr);
+    explicit AudioDisplay(ClockDomain *clockDomain, QObject *parent = nullptr);
     ~AudioDisplay() override;
 
     void setVolume(qreal volume);
 
     void setMasterClock();
 
-signals:
-    void positionChanged(qint64 position); // microsecond
-
 protected:
-    void runDecoder() override;
+    void onDecoderStarted() override;
+    void onDecoderStopped() override;
+    auto runDecoderStep() -> bool override;
 
 private:
     class AudioDisplayPrivate;
@@ -3,6 +3,8 @@
 #include "codeccontext.h"
 #include "frame.hpp"
 
+#include <utils/spscbytering.hpp>
+
 #include <QAudioDevice>
 #include <QDebug>
 #include <QMediaDevices>
@@ -182,6 +184,43 @@ auto AudioFrameConverter::convert(Frame *frame) -> QByteArray
     return data;
 }
 
+auto AudioFrameConverter::convert(Frame *frame, Utils::SpscByteRing &ring) -> qint64
+{
+    auto *avFrame = frame->avFrame();
+    auto bytesPerFrame = d_ptr->format.bytesPerFrame();
+    const auto **in = const_cast<const uint8_t **>(avFrame->extended_data);
+    auto inCount = avFrame->nb_samples;
+    qint64 written = 0;
+    while (true) {
+        qint64 size = 0;
+        auto *data = ring.writeSpan(size);
+        auto outCount = static_cast<int>(size / bytesPerFrame);
+        if (outCount == 0 && inCount == 0) {
+            break;
+        }
+        // with no room the input is only buffered in the resampler
+        quint8 *bufPointer[] = {reinterpret_cast<quint8 *>(data)};
+        auto len = swr_convert(d_ptr->swrContext,
+                               outCount > 0 ? bufPointer : nullptr,
+                               outCount,
+                               in,
+                               inCount);
+        if (len < 0) {
+            SET_ERROR_CODE(len);
+            return len;
+        }
+        inCount = 0;
+        ring.commitWrite(static_cast<qint64>(len) * bytesPerFrame);
+        written += static_cast<qint64>(len) * bytesPerFrame;
+        // less than asked means the resampler is drained, a full span may be followed by the
+        // wrapped part of the ring
+        if (len < outCount || outCount == 0) {
+            break;
+        }
+    }
+    return written;
+}
+
 auto getAudioFormatFromCodecCtx(CodecContext *codecCtx, int &sampleSize) -> QAudioFormat
 {
     auto *ctx = codecCtx->avCodecCtx();
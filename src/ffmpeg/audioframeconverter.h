@@ -6,6 +6,10 @@ extern "C" {
 #include <libavutil/channel_layout.h>
 }
 
+namespace Utils {
+class SpscByteRing;
+} // namespace Utils
+
 namespace Ffmpeg {
 
 class CodecContext;
@@ -19,6 +23,9 @@ public:
     ~AudioFrameConverter() override;
 
     auto convert(Frame *frame) -> QByteArray;
+    // Resample straight into the ring, returns the bytes written or a negative AVERROR.
+    // Output that does not fit stays in the resampler and comes out first on the next call.
+    auto convert(Frame *frame, Utils::SpscByteRing &ring) -> qint64;
 
 private:
     class AudioFrameConverterPrivate;
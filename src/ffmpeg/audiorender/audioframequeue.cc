@@ -0,0 +1,82 @@
+#include "audioframequeue.hpp"
+
+extern "C" {
+#include <libavutil/avutil.h>
+}
+
+namespace Ffmpeg {
+
+// element bound for codecs with tiny frames like truehd, the pts span is what normally limits
+static constexpr auto s_audioFrameQueueSize = 256;
+// microseconds
+static constexpr auto s_audioFrameQueueDuration = AV_TIME_BASE / 5;
+
+AudioFrameQueue::AudioFrameQueue()
+    : m_queue(s_audioFrameQueueSize)
+{
+    m_queue.setDurationLimit(s_audioFrameQueueDuration, [](const FramePtr &framePtr) {
+        if (framePtr.isNull() || framePtr->avFrame()->pts == AV_NOPTS_VALUE) {
+            return Utils::s_invalidQueueTimestamp;
+        }
+        return framePtr->pts();
+    });
+}
+
+AudioFrameQueue::~AudioFrameQueue() = default;
+
+void AudioFrameQueue::setTakenCallback(std::function<void()> callback)
+{
+    m_queue.setNotifyCallbacks(nullptr, std::move(callback));
+}
+
+auto AudioFrameQueue::tryAppend(FramePtr &&framePtr) -> bool
+{
+    if (!m_queue.tryAppend(std::move(framePtr))) {
+        return false;
+    }
+    m_appended.fetch_add(1);
+    return true;
+}
+
+void AudioFrameQueue::flush()
+{
+    m_flushTo.store(m_appended.load());
+    m_flushRequests.fetch_add(1);
+}
+
+auto AudioFrameQueue::tryTake(FramePtr &framePtr) -> bool
+{
+    if (!m_queue.tryTake(framePtr)) {
+        return false;
+    }
+    m_taken++;
+    return true;
+}
+
+auto AudioFrameQueue::takeFlush() -> bool
+{
+    auto requests = m_flushRequests.load();
+    if (requests == m_flushHandled) {
+        return false;
+    }
+    m_flushHandled = requests;
+    // a later flush can only move the mark forward, frames appended after it are kept
+    auto flushTo = m_flushTo.load();
+    FramePtr framePtr;
+    while (m_taken < flushTo && tryTake(framePtr)) {
+        framePtr.reset();
+    }
+    return true;
+}
+
+auto AudioFrameQueue::size() const -> size_t
+{
+    return m_queue.size();
+}
+
+auto AudioFrameQueue::duration() const -> qint64
+{
+    return m_queue.duration();
+}
+
+} // namespace Ffmpeg
@@ -0,0 +1,47 @@
+#ifndef AUDIOFRAMEQUEUE_HPP
+#define AUDIOFRAMEQUEUE_HPP
+
+#include <ffmpeg/frame.hpp>
+#include <utils/boundedspscqueue.hpp>
+
+namespace Ffmpeg {
+
+// Hands decoded audio frames from AudioDisplay to the thread QAudioSink pulls on, without
+// queued signals. Bounded by pts span, so only a little audio waits behind the sink buffer.
+class AudioFrameQueue
+{
+    Q_DISABLE_COPY_MOVE(AudioFrameQueue);
+
+public:
+    AudioFrameQueue();
+    ~AudioFrameQueue();
+
+    // Not thread safe, call before use. Called on the sink thread whenever frames are taken,
+    // a display waiting on a full queue resumes from here.
+    void setTakenCallback(std::function<void()> callback);
+
+    // display thread, non-blocking, framePtr is left untouched if the queue is full
+    auto tryAppend(FramePtr &&framePtr) -> bool;
+    // display thread, everything appended so far is dropped by the sink thread
+    void flush();
+
+    // sink thread
+    auto tryTake(FramePtr &framePtr) -> bool;
+    // sink thread, true once after every flush(), the flushed frames are discarded by then
+    auto takeFlush() -> bool;
+
+    [[nodiscard]] auto size() const -> size_t;
+    [[nodiscard]] auto duration() const -> qint64; // microseconds
+
+private:
+    Utils::BoundedSpscQueue<FramePtr> m_queue;
+    std::atomic<quint64> m_appended = 0; // written by display
+    std::atomic<quint64> m_flushTo = 0;
+    std::atomic<quint64> m_flushRequests = 0;
+    quint64 m_taken = 0;        // sink thread only
+    quint64 m_flushHandled = 0; // sink thread only
+};
+
+} // namespace Ffmpeg
+
+#endif // AUDIOFRAMEQUEUE_HPP
@@ -1,8 +1,8 @@
 #include "audiooutput.hpp"
+#include "audiooutputdevice.hpp"
 
 #include <ffmpeg/audioframeconverter.h>
 #include <ffmpeg/avcontextinfo.h>
-#include <utils/threadsafequeue.hpp>
 
 #include <QApplication>
 #include <QAudioSink>
@@ -11,6 +11,9 @@
 
 namespace Ffmpeg {
 
+// the sink pulls on demand, so its buffer only has to ride out scheduling jitter, microseconds
+static constexpr auto s_audioSinkBufferLatency = 100 * 1000;
+
 void printAudioOuputDevice()
 {
     const auto audioDevices = QMediaDevices::audioOutputs();
@@ -34,16 +37,27 @@ public:
         printAudioOuputDevice();
         audioDevice = QMediaDevices::defaultAudioOutput();
 
+        // the old sink may still be pulling from the old device
+        audioSinkPtr.reset();
+        outputDevicePtr.reset();
+
         int sampleSize = 0;
         auto format = getAudioFormatFromCodecCtx(contextInfo->codecCtx(), sampleSize);
         audioConverterPtr.reset(new AudioFrameConverter(contextInfo->codecCtx(), format));
+        outputDevicePtr.reset(
+            new AudioOutputDevice(frameQueue, audioConverterPtr.data(), format, clock));
+        outputDevicePtr->open(QIODevice::ReadOnly);
 
         audioSinkPtr.reset(new QAudioSink(format));
-        audioSinkPtr->setBufferSize(format.sampleRate() * sampleSize / 8);
+        outputDevicePtr->setAudioSink(audioSinkPtr.data());
+        audioSinkPtr->setBufferSize(format.bytesForDuration(s_audioSinkBufferLatency));
         audioSinkPtr->setVolume(volume);
-        ioDevice = audioSinkPtr->start();
-        if (ioDevice == nullptr) {
-            qWarning() << "Create AudioDevice Failed!";
+        audioSinkPtr->start(outputDevicePtr.data());
+        if (audioSinkPtr->error() != QAudio::NoError) {
+            qWarning() << "Create AudioDevice Failed!" << audioSinkPtr->error();
+        }
+        if (paused) {
+            audioSinkPtr->suspend();
         }
         QObject::connect(audioSinkPtr.data(),
                          &QAudioSink::stateChanged,
@@ -54,22 +68,30 @@ public:
     AudioOutput *q_ptr;
 
     AVContextInfo *contextInfo;
+    AudioFrameQueue *frameQueue;
+    Clock *clock;
 
     QScopedPointer<AudioFrameConverter> audioConverterPtr;
+    QScopedPointer<AudioOutputDevice> outputDevicePtr;
 
     qreal volume = 0.5;
+    bool paused = false;
     QScopedPointer<QAudioSink> audioSinkPtr;
-    QIODevice *ioDevice = nullptr;
     QMediaDevices *mediaDevices;
     QAudioDevice audioDevice;
-    QByteArray audioBuf;
 };
 
-AudioOutput::AudioOutput(AVContextInfo *contextInfo, qreal volume, QObject *parent)
+AudioOutput::AudioOutput(AVContextInfo *contextInfo,
+                         AudioFrameQueue *frameQueue,
+                         Clock *clock,
+                         qreal volume,
+                         QObject *parent)
     : QObject{parent}
     , d_ptr(new AudioOutputPrivate(this))
 {
     d_ptr->contextInfo = contextInfo;
+    d_ptr->frameQueue = frameQueue;
+    d_ptr->clock = clock;
     d_ptr->volume = volume;
     d_ptr->reset();
     buildConnect();
@@ -77,41 +99,27 @@ AudioOutput::AudioOutput(AVContextInfo *contextInfo, qreal volume, QObject *pare
 
 AudioOutput::~AudioOutput() = default;
 
-void AudioOutput::onConvertData(const QSharedPointer<Ffmpeg::Frame> &framePtr)
-{
-    if (d_ptr->ioDevice == nullptr) {
-        return;
-    }
-
-    auto audioBuf = d_ptr->audioConverterPtr->convert(framePtr.data());
-    d_ptr->audioBuf += audioBuf;
-}
-
-void AudioOutput::onWrite()
+void AudioOutput::onSetVolume(qreal value)
 {
-    if (d_ptr->ioDevice == nullptr) {
+    d_ptr->volume = value;
+    if (d_ptr->audioSinkPtr.isNull()) {
         return;
     }
-    while (d_ptr->audioBuf.size() > 0) {
-        auto byteFree = d_ptr->audioSinkPtr->bytesFree();
-        if (byteFree > 0 && byteFree < d_ptr->audioBuf.size()) {
-            d_ptr->ioDevice->write(d_ptr->audioBuf.data(), byteFree);
-            d_ptr->audioBuf = d_ptr->audioBuf.sliced(byteFree);
-        } else {
-            d_ptr->ioDevice->write(d_ptr->audioBuf);
-            d_ptr->audioBuf.clear();
-            break;
-        }
-    }
+    d_ptr->audioSinkPtr->setVolume(value);
 }
 
-void AudioOutput::onSetVolume(qreal value)
+// a suspended sink stops pulling, what it already buffered is played after the resume
+void AudioOutput::onSetPaused(bool paused)
 {
-    d_ptr->volume = value;
+    d_ptr->paused = paused;
     if (d_ptr->audioSinkPtr.isNull()) {
         return;
     }
-    d_ptr->audioSinkPtr->setVolume(value);
+    if (paused) {
+        d_ptr->audioSinkPtr->suspend();
+    } else {
+        d_ptr->audioSinkPtr->resume();
+    }
 }
 
 void AudioOutput::onStateChanged(QAudio::State state)
@@ -7,19 +7,23 @@
 namespace Ffmpeg {
 
 class AVContextInfo;
-class Frame;
+class AudioFrameQueue;
+class Clock;
 
 class AudioOutput : public QObject
 {
     Q_OBJECT
 public:
-    explicit AudioOutput(AVContextInfo *contextInfo, qreal volume = 0.5, QObject *parent = nullptr);
+    explicit AudioOutput(AVContextInfo *contextInfo,
+                         AudioFrameQueue *frameQueue,
+                         Clock *clock,
+                         qreal volume = 0.5,
+                         QObject *parent = nullptr);
     ~AudioOutput() override;
 
 public slots:
-    void onConvertData(const QSharedPointer<Ffmpeg::Frame> &framePtr);
-    void onWrite();
     void onSetVolume(qreal value);
+    void onSetPaused(bool paused);
 
 private slots:
     void onStateChanged(QAudio::State state);
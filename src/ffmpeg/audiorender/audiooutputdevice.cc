@@ -0,0 +1,137 @@
+#include "audiooutputdevice.hpp"
+#include "audioframequeue.hpp"
+
+#include <ffmpeg/audioframeconverter.h>
+#include <ffmpeg/clock.hpp>
+#include <utils/spscbytering.hpp>
+
+#include <QAudioSink>
+
+extern "C" {
+#include <libavutil/avutil.h>
+#include <libavutil/time.h>
+}
+
+namespace Ffmpeg {
+
+// converted audio of the frame being read, microseconds
+static constexpr auto s_audioRingLatency = 200 * 1000;
+
+class AudioOutputDevice::AudioOutputDevicePrivate
+{
+public:
+    explicit AudioOutputDevicePrivate(AudioOutputDevice *q)
+        : q_ptr(q)
+    {}
+
+    // microseconds of audio written to the sink but not played yet
+    [[nodiscard]] auto sinkLatency() const -> qint64
+    {
+        if (audioSink == nullptr) {
+            return 0;
+        }
+        // bytesFree only covers the buffer of QAudioSink, processedUSecs also counts what the
+        // backend took but did not play yet on some platforms, the larger one is closer
+        auto buffered = format.durationForBytes(audioSink->bufferSize() - audioSink->bytesFree());
+        auto unprocessed = readUSecs - audioSink->processedUSecs();
+        return qMax(qMax(buffered, unprocessed), qint64(0));
+    }
+
+    // pts covered by the given microseconds of output
+    [[nodiscard]] auto ptsSpan(qint64 usecs) const -> qint64
+    {
+        return static_cast<qint64>(usecs * clock->speed());
+    }
+
+    void updateClock(qint64 readed)
+    {
+        if (ringEndPts == AV_NOPTS_VALUE || readed <= 0) {
+            return;
+        }
+        auto readEndPts = ringEndPts - ptsSpan(format.durationForBytes(audioRing.size()));
+        auto readStartPts = readEndPts - ptsSpan(format.durationForBytes(readed));
+        auto audiblePts = readStartPts - ptsSpan(sinkLatency());
+        clock->update(audiblePts, av_gettime_relative());
+    }
+
+    AudioOutputDevice *q_ptr;
+
+    AudioFrameQueue *frameQueue = nullptr;
+    AudioFrameConverter *converter = nullptr;
+    Clock *clock = nullptr;
+    QAudioSink *audioSink = nullptr;
+    QAudioFormat format;
+    // allocated once per format, a frame is converted in place and read out without moves
+    Utils::SpscByteRing audioRing;
+    int bytesPerFrame = 1;
+    // pts just after the last byte in the ring
+    qint64 ringEndPts = AV_NOPTS_VALUE;
+    // microseconds of audio handed to the sink since it started
+    qint64 readUSecs = 0;
+};
+
+AudioOutputDevice::AudioOutputDevice(AudioFrameQueue *frameQueue,
+                                     AudioFrameConverter *converter,
+                                     const QAudioFormat &format,
+                                     Clock *clock,
+                                     QObject *parent)
+    : QIODevice(parent)
+    , d_ptr(new AudioOutputDevicePrivate(this))
+{
+    d_ptr->frameQueue = frameQueue;
+    d_ptr->converter = converter;
+    d_ptr->clock = clock;
+    d_ptr->format = format;
+    d_ptr->bytesPerFrame = qMax(format.bytesPerFrame(), 1);
+    // bytesForDuration is a whole number of frames, so spans never split a frame
+    d_ptr->audioRing.reset(qMax(format.bytesForDuration(s_audioRingLatency), d_ptr->bytesPerFrame));
+}
+
+AudioOutputDevice::~AudioOutputDevice() = default;
+
+void AudioOutputDevice::setAudioSink(QAudioSink *audioSink)
+{
+    d_ptr->audioSink = audioSink;
+    d_ptr->readUSecs = 0;
+}
+
+auto AudioOutputDevice::bytesAvailable() const -> qint64
+{
+    return d_ptr->audioRing.size() + QIODevice::bytesAvailable();
+}
+
+auto AudioOutputDevice::readData(char *data, qint64 maxSize) -> qint64
+{
+    auto &audioRing = d_ptr->audioRing;
+    if (d_ptr->frameQueue->takeFlush()) {
+        audioRing.clear();
+        d_ptr->ringEndPts = AV_NOPTS_VALUE;
+    }
+    // whole frames only, a partial frame would shift the channels of everything after it
+    maxSize -= maxSize % d_ptr->bytesPerFrame;
+    auto readed = audioRing.read(data, maxSize);
+    FramePtr framePtr;
+    while (readed < maxSize && d_ptr->frameQueue->tryTake(framePtr)) {
+        // the ring is empty here, everything in it after the convert belongs to this frame
+        d_ptr->converter->convert(framePtr.data(), audioRing);
+        if (framePtr->avFrame()->pts != AV_NOPTS_VALUE) {
+            d_ptr->ringEndPts = framePtr->pts()
+                                + d_ptr->ptsSpan(d_ptr->format.durationForBytes(audioRing.size()));
+        }
+        framePtr.reset();
+        readed += audioRing.read(data + readed, maxSize - readed);
+    }
+    d_ptr->updateClock(readed);
+    d_ptr->readUSecs += d_ptr->format.durationForBytes(readed);
+    // nothing queued leaves the sink idle, it keeps polling the device
+    return readed;
+}
+
+auto AudioOutputDevice::writeData(const char *data, qint64 maxSize) -> qint64
+{
+    Q_UNUSED(data)
+    Q_UNUSED(maxSize)
+    return -1;
+}
+
+} // namespace Ffmpeg
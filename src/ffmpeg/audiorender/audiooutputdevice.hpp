@@ -0,0 +1,46 @@
+#ifndef AUDIOOUTPUTDEVICE_HPP
+#define AUDIOOUTPUTDEVICE_HPP
+
+#include <QAudioFormat>
+#include <QIODevice>
+
+class QAudioSink;
+
+namespace Ffmpeg {
+
+class AudioFrameConverter;
+class AudioFrameQueue;
+class Clock;
+
+// Pull mode source of QAudioSink, frames are taken from the AudioFrameQueue and converted only
+// when the sink asks for more data, so the device clock paces the audio path.
+// Every read moves the audio clock to the pts that is audible right now, that is the pts of the
+// data read minus what is still buffered in the sink.
+class AudioOutputDevice : public QIODevice
+{
+public:
+    explicit AudioOutputDevice(AudioFrameQueue *frameQueue,
+                               AudioFrameConverter *converter,
+                               const QAudioFormat &format,
+                               Clock *clock,
+                               QObject *parent = nullptr);
+    ~AudioOutputDevice() override;
+
+    // the sink reading this device, its buffer level gives the output latency
+    void setAudioSink(QAudioSink *audioSink);
+
+    [[nodiscard]] auto isSequential() const -> bool override { return true; }
+    [[nodiscard]] auto bytesAvailable() const -> qint64 override;
+
+protected:
+    auto readData(char *data, qint64 maxSize) -> qint64 override;
+    auto writeData(const char *data, qint64 maxSize) -> qint64 override;
+
+private:
+    class AudioOutputDevicePrivate;
+    QScopedPointer<AudioOutputDevicePrivate> d_ptr;
+};
+
+} // namespace Ffmpeg
+
+#endif // AUDIOOUTPUTDEVICE_HPP
@@ -1,8 +1,7 @@
 #include "audiooutputthread.hpp"
+#include "audioframequeue.hpp"
 #include "audiooutput.hpp"
 
-#include <ffmpeg/frame.hpp>
-
 namespace Ffmpeg {
 
 class AudioOutputThread::AudioOutputThreadPrivate
@@ -15,25 +14,26 @@ public:
     AudioOutputThread *q_ptr;
 
     AVContextInfo *contextInfo;
+    Clock *clock;
     qreal volume = 0.5;
+    AudioFrameQueue frameQueue;
 };
 
 AudioOutputThread::AudioOutputThread(QObject *parent)
     : QThread{parent}
     , d_ptr(new AudioOutputThreadPrivate(this))
-{
-    qRegisterMetaType<QSharedPointer<Ffmpeg::Frame>>("QSharedPointer<Ffmpeg::Frame>");
-}
+{}
 
 AudioOutputThread::~AudioOutputThread()
 {
     closeOutput();
 }
 
-void AudioOutputThread::openOutput(AVContextInfo *contextInfo, qreal volume)
+void AudioOutputThread::openOutput(AVContextInfo *contextInfo, Clock *clock, qreal volume)
 {
     closeOutput();
     d_ptr->contextInfo = contextInfo;
+    d_ptr->clock = clock;
     d_ptr->volume = volume;
     start();
 }
@@ -46,18 +46,23 @@ void AudioOutputThread::closeOutput()
     }
 }
 
+auto AudioOutputThread::frameQueue() -> AudioFrameQueue *
+{
+    return &d_ptr->frameQueue;
+}
+
 void AudioOutputThread::run()
 {
-    QScopedPointer<AudioOutput> audioOutputPtr(new AudioOutput(d_ptr->contextInfo, d_ptr->volume));
-    connect(this,
-            &AudioOutputThread::convertData,
-            audioOutputPtr.data(),
-            &AudioOutput::onConvertData);
-    connect(this, &AudioOutputThread::wirteData, audioOutputPtr.data(), &AudioOutput::onWrite);
+    QScopedPointer<AudioOutput> audioOutputPtr(
+        new AudioOutput(d_ptr->contextInfo, &d_ptr->frameQueue, d_ptr->clock, d_ptr->volume));
     connect(this,
             &AudioOutputThread::volumeChanged,
             audioOutputPtr.data(),
             &AudioOutput::onSetVolume);
+    connect(this,
+            &AudioOutputThread::pausedChanged,
+            audioOutputPtr.data(),
+            &AudioOutput::onSetPaused);
     exec();
 }
 
@@ -5,8 +5,9 @@
 
 namespace Ffmpeg {
 
-class Frame;
 class AVContextInfo;
+class AudioFrameQueue;
+class Clock;
 
 class AudioOutputThread : public QThread
 {
@@ -15,13 +16,16 @@ public:
     explicit AudioOutputThread(QObject *parent = nullptr);
     ~AudioOutputThread() override;
 
-    void openOutput(AVContextInfo *contextInfo, qreal volume);
+    // clock is moved to the audible pts whenever the sink pulls data
+    void openOutput(AVContextInfo *contextInfo, Clock *clock, qreal volume);
     void closeOutput();
 
+    // frames appended here are pulled by the sink when it needs data
+    auto frameQueue() -> AudioFrameQueue *;
+
 signals:
-    void convertData(const QSharedPointer<Ffmpeg::Frame> &frameptr);
-    void wirteData();
     void volumeChanged(qreal value);
+    void pausedChanged(bool paused);
 
 protected:
     void run() override;
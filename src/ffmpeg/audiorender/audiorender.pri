@@ -1,7 +1,11 @@
 HEADERS += \
+    $$PWD/audioframequeue.hpp \
     $$PWD/audiooutput.hpp \
+    $$PWD/audiooutputdevice.hpp \
     $$PWD/audiooutputthread.hpp
 
 SOURCES += \
+    $$PWD/audioframequeue.cc \
     $$PWD/audiooutput.cc \
+    $$PWD/audiooutputdevice.cc \
     $$PWD/audiooutputthread.cc
@@ -33,6 +33,9 @@ public:
     QScopedPointer<HardWareDecode> hardWareDecodePtr;
     QScopedPointer<HardWareEncode> hardWareEncodePtr;
     GpuType gpuType = GpuType::NotUseGpu;
+
+    FramePool framePool;
+    PacketPool packetPool;
 };
 
 AVContextInfo::AVContextInfo(QObject *parent)
@@ -77,7 +80,8 @@ auto AVContextInfo::stream() -> AVStream *
     return d_ptr->stream;
 }
 
-auto AVContextInfo::initDecoder(const AVRational &frameRate) -> bool
+auto AVContextInfo::initDecoder(const AVRational &frameRate,
+                                const ThreadingPolicy &threadingPolicy) -> bool
 {
     Q_ASSERT(d_ptr->stream != nullptr);
     const auto *typeStr = av_get_media_type_string(d_ptr->stream->codecpar->codec_type);
@@ -92,10 +96,10 @@ auto AVContextInfo::initDecoder(const AVRational &frameRate) -> bool
     }
     auto *avCodecCtx = d_ptr->codecCtx->avCodecCtx();
     avCodecCtx->pkt_timebase = d_ptr->stream->time_base;
-    d_ptr->codecCtx->setThreadCount(4);
     if (d_ptr->stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
         avCodecCtx->framerate = frameRate;
     }
+    threadingPolicy.apply(avCodecCtx);
 
     return true;
 }
@@ -149,56 +153,80 @@ auto AVContextInfo::openCodec(GpuType type) -> bool
 }
 
 auto AVContextInfo::decodeSubtitle2(const QSharedPointer<Subtitle> &subtitlePtr,
-                                    const QSharedPointer<Packet> &packetPtr) -> bool
+                                    const PacketPtr &packetPtr) -> bool
 {
     return d_ptr->codecCtx->decodeSubtitle2(subtitlePtr.data(), packetPtr.data());
 }
 
-auto AVContextInfo::decodeFrame(const QSharedPointer<Packet> &packetPtr)
-    -> std::vector<QSharedPointer<Frame>>
+auto AVContextInfo::decodeFrame(const PacketPtr &packetPtr) -> std::vector<FramePtr>
 {
     std::vector<FramePtr> framePtrs;
+    decodeFrame(packetPtr, framePtrs);
+    return framePtrs;
+}
+
+auto AVContextInfo::encodeFrame(const FramePtr &framePtr) -> std::vector<PacketPtr>
+{
+    std::vector<PacketPtr> packetPtrs{};
+    encodeFrame(framePtr, packetPtrs);
+    return packetPtrs;
+}
+
+auto AVContextInfo::decodeFrame(const PacketPtr &packetPtr,
+                                std::vector<FramePtr> &framePtrs,
+                                qint64 discardBefore) -> bool
+{
     if (!d_ptr->codecCtx->sendPacket(packetPtr.data())) {
-        return framePtrs;
+        return false;
     }
-    FramePtr framePtr(new Frame);
+    // the last, failing receiveFrame goes back to the pool instead of being freed
+    auto framePtr = d_ptr->framePool.acquire();
     while (d_ptr->codecCtx->receiveFrame(framePtr.data())) {
-        framePtr->avFrame()->time_base = stream()->time_base;
+        auto *avFrame = framePtr->avFrame();
+        avFrame->time_base = stream()->time_base;
+        // receiveFrame unrefs the frame, a dropped one is simply reused
+        if (discardBefore != std::numeric_limits<qint64>::min() && avFrame->pts != AV_NOPTS_VALUE
+            && av_rescale_q(avFrame->pts, avFrame->time_base, AVRational{1, AV_TIME_BASE})
+                   < discardBefore) {
+            continue;
+        }
         if (d_ptr->gpuType == GpuDecode && mediaType() == AVMEDIA_TYPE_VIDEO) {
             bool ok = false;
-            framePtr = d_ptr->hardWareDecodePtr->transFromGpu(framePtr, ok);
+            framePtr = d_ptr->hardWareDecodePtr->transFromGpu(framePtr, d_ptr->framePool, ok);
             if (!ok) {
-                return framePtrs;
+                return false;
             }
         }
         framePtrs.push_back(framePtr);
-        framePtr.reset(new Frame);
+        framePtr = d_ptr->framePool.acquire();
     }
-    return framePtrs;
+    return true;
 }
 
-auto AVContextInfo::encodeFrame(const QSharedPointer<Frame> &framePtr)
-    -> std::vector<QSharedPointer<Packet>>
+auto AVContextInfo::encodeFrame(const FramePtr &framePtr,
+                                std::vector<PacketPtr> &packetPtrs) -> bool
 {
-    std::vector<PacketPtr> packetPtrs{};
     auto frame_tmp_ptr = framePtr;
     if (d_ptr->gpuType == GpuEncode && mediaType() == AVMEDIA_TYPE_VIDEO
         && framePtr->avFrame() != nullptr) {
         bool ok = false;
-        frame_tmp_ptr = d_ptr->hardWareEncodePtr->transToGpu(d_ptr->codecCtx.data(), framePtr, ok);
+        frame_tmp_ptr = d_ptr->hardWareEncodePtr->transToGpu(d_ptr->codecCtx.data(),
+                                                             framePtr,
+                                                             d_ptr->framePool,
+                                                             ok);
         if (!ok) {
-            return packetPtrs;
+            return false;
         }
     }
     if (!d_ptr->codecCtx->sendFrame(frame_tmp_ptr.data())) {
-        return packetPtrs;
+        return false;
     }
-    PacketPtr packetPtr(new Packet);
+    auto packetPtr = d_ptr->packetPool.acquire();
     while (d_ptr->codecCtx->receivePacket(packetPtr.get())) {
         packetPtrs.push_back(packetPtr);
-        packetPtr.reset(new Packet);
+        packetPtr = d_ptr->packetPool.acquire();
     }
-    return packetPtrs;
+    return true;
 }
 
 auto AVContextInfo::calTimebase() const -> double
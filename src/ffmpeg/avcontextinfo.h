@@ -2,9 +2,14 @@
 #define AVCONTEXTINFO_H
 
 #include "ffmepg_global.h"
+#include "frame.hpp"
+#include "packet.h"
+#include "threadingpolicy.hpp"
 
 #include <QObject>
 
+#include <limits>
+
 extern "C" {
 #include <libavcodec/codec.h>
 }
@@ -14,8 +19,6 @@ struct AVStream;
 namespace Ffmpeg {
 
 class Subtitle;
-class Packet;
-class Frame;
 class CodecContext;
 
 class FFMPEG_EXPORT AVContextInfo : public QObject
@@ -35,16 +38,24 @@ public:
     void setStream(AVStream *stream);
     auto stream() -> AVStream *;
 
-    auto initDecoder(const AVRational &frameRate) -> bool;
+    auto initDecoder(const AVRational &frameRate,
+                     const ThreadingPolicy &threadingPolicy = ThreadingPolicy::playback()) -> bool;
     auto initEncoder(AVCodecID codecId) -> bool;
     auto initEncoder(const QString &name) -> bool;
     auto openCodec(GpuType type = NotUseGpu) -> bool;
 
     // sendPacket and receiveFrame
-    auto decodeFrame(const QSharedPointer<Packet> &packetPtr) -> std::vector<QSharedPointer<Frame>>;
-    auto encodeFrame(const QSharedPointer<Frame> &framePtr) -> std::vector<QSharedPointer<Packet>>;
+    auto decodeFrame(const PacketPtr &packetPtr) -> std::vector<FramePtr>;
+    auto encodeFrame(const FramePtr &framePtr) -> std::vector<PacketPtr>;
+    // Append to caller owned storage, frames and packets come from the pools of this stream.
+    // Return false if sending failed or a frame could not be transferred from the gpu.
+    // Frames with a pts before discardBefore, microseconds, are dropped before the transfer.
+    auto decodeFrame(const PacketPtr &packetPtr,
+                     std::vector<FramePtr> &framePtrs,
+                     qint64 discardBefore = std::numeric_limits<qint64>::min()) -> bool;
+    auto encodeFrame(const FramePtr &framePtr, std::vector<PacketPtr> &packetPtrs) -> bool;
     auto decodeSubtitle2(const QSharedPointer<Subtitle> &subtitlePtr,
-                         const QSharedPointer<Packet> &packetPtr) -> bool;
+                         const PacketPtr &packetPtr) -> bool;
 
     [[nodiscard]] auto calTimebase() const -> double;
     [[nodiscard]] auto timebase() const -> AVRational;
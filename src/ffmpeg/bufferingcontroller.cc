@@ -0,0 +1,138 @@
+#include "bufferingcontroller.hpp"
+
+extern "C" {
+#include <libavutil/avutil.h>
+}
+
+namespace Ffmpeg {
+
+static constexpr qint64 s_minLookAhead = 2 * AV_TIME_BASE;
+static constexpr qint64 s_maxLookAhead = 30 * AV_TIME_BASE;
+// look-ahead added by every underrun of the session
+static constexpr qint64 s_stallPenalty = 2 * AV_TIME_BASE;
+// less buffered than this on the master stream is about to underrun
+static constexpr qint64 s_underrunThreshold = AV_TIME_BASE / 5;
+// throughput over bitrate above which the minimum look-ahead is enough
+static constexpr double s_comfortMargin = 2.0;
+// read time a throughput sample spans, single reads are too short to measure
+static constexpr qint64 s_sampleTime = AV_TIME_BASE / 10;
+
+class BufferingController::BufferingControllerPrivate
+{
+public:
+    explicit BufferingControllerPrivate(BufferingController *q)
+        : q_ptr(q)
+    {}
+
+    BufferingController *q_ptr;
+
+    qint64 bitRate = 0;
+    qint64 throughput = 0;
+    qint64 sampleBytes = 0;
+    qint64 sampleTime = 0;
+
+    qint64 bufferedDuration = 0;
+    bool buffering = false;
+    // the master stream was buffered past the threshold since the start or the last seek,
+    // running dry after that is an underrun
+    bool primed = false;
+    int stalls = 0;
+};
+
+BufferingController::BufferingController()
+    : d_ptr(new BufferingControllerPrivate(this))
+{}
+
+BufferingController::~BufferingController() = default;
+
+void BufferingController::reset(qint64 bitRate)
+{
+    d_ptr->bitRate = qMax(bitRate, qint64(0));
+    d_ptr->throughput = d_ptr->sampleBytes = d_ptr->sampleTime = 0;
+    d_ptr->bufferedDuration = 0;
+    d_ptr->buffering = false;
+    d_ptr->primed = false;
+    d_ptr->stalls = 0;
+}
+
+void BufferingController::addRead(qint64 bytes, qint64 elapsed)
+{
+    d_ptr->sampleBytes += bytes;
+    d_ptr->sampleTime += qMax(elapsed, qint64(0));
+    if (d_ptr->sampleTime < s_sampleTime) {
+        return;
+    }
+    auto rate = d_ptr->sampleBytes * AV_TIME_BASE / d_ptr->sampleTime;
+    d_ptr->throughput = d_ptr->throughput == 0 ? rate : (d_ptr->throughput * 7 + rate * 3) / 10;
+    d_ptr->sampleBytes = d_ptr->sampleTime = 0;
+}
+
+auto BufferingController::throughput() const -> qint64
+{
+    return d_ptr->throughput;
+}
+
+auto BufferingController::lookAheadDuration() const -> qint64
+{
+    auto duration = s_minLookAhead;
+    if (d_ptr->bitRate > 0 && d_ptr->throughput > 0) {
+        auto margin = d_ptr->throughput * 8.0 / d_ptr->bitRate;
+        if (margin < s_comfortMargin) {
+            duration = static_cast<qint64>(s_minLookAhead * s_comfortMargin / qMax(margin, 0.1));
+        }
+    }
+    duration += d_ptr->stalls * s_stallPenalty;
+    return qMin(duration, s_maxLookAhead);
+}
+
+auto BufferingController::lookAheadBytes() const -> qint64
+{
+    return av_rescale(lookAheadDuration(), d_ptr->bitRate, 8LL * AV_TIME_BASE);
+}
+
+auto BufferingController::update(qint64 bufferedDuration, bool canFill) -> bool
+{
+    d_ptr->bufferedDuration = bufferedDuration;
+    if (!d_ptr->buffering) {
+        if (bufferedDuration >= s_underrunThreshold) {
+            d_ptr->primed = true;
+            return false;
+        }
+        if (!canFill) {
+            return false;
+        }
+        if (d_ptr->primed) {
+            d_ptr->stalls++;
+        }
+        d_ptr->buffering = true;
+        return true;
+    }
+    if (canFill && bufferedDuration < qMax(lookAheadDuration() / 2, s_underrunThreshold)) {
+        return false;
+    }
+    d_ptr->buffering = false;
+    d_ptr->primed = true;
+    return true;
+}
+
+auto BufferingController::isBuffering() const -> bool
+{
+    return d_ptr->buffering;
+}
+
+void BufferingController::stopBuffering()
+{
+    d_ptr->buffering = false;
+}
+
+void BufferingController::seeked()
+{
+    d_ptr->primed = false;
+}
+
+auto BufferingController::bufferedDuration() const -> qint64
+{
+    return d_ptr->bufferedDuration;
+}
+
+} // namespace Ffmpeg
@@ -0,0 +1,47 @@
+#ifndef BUFFERINGCONTROLLER_HPP
+#define BUFFERINGCONTROLLER_HPP
+
+#include <QtCore>
+
+namespace Ffmpeg {
+
+// Buffering policy of network playback.
+// The look-ahead the demuxer fills grows when the measured read throughput leaves little margin
+// over the bitrate and after every underrun. Playback waits for data once the master stream is
+// about to run dry, and resumes when half of the look-ahead is buffered. Player thread only.
+class BufferingController
+{
+    Q_DISABLE_COPY_MOVE(BufferingController)
+public:
+    BufferingController();
+    ~BufferingController();
+
+    // for a new session, bitRate in bits per second, 0 if unknown
+    void reset(qint64 bitRate);
+
+    // bytes of one read and the microseconds it blocked
+    void addRead(qint64 bytes, qint64 elapsed);
+    [[nodiscard]] auto throughput() const -> qint64; // bytes per second
+
+    [[nodiscard]] auto lookAheadDuration() const -> qint64; // microseconds
+    // 0 if the bitrate is unknown
+    [[nodiscard]] auto lookAheadBytes() const -> qint64;
+
+    // takes the buffered duration of the master stream, canFill is false when the demuxer cannot
+    // read more, true if isBuffering() changed
+    auto update(qint64 bufferedDuration, bool canFill) -> bool;
+    [[nodiscard]] auto isBuffering() const -> bool;
+    void stopBuffering();
+    // the queues were flushed, waiting for the new position does not count as an underrun
+    void seeked();
+
+    [[nodiscard]] auto bufferedDuration() const -> qint64; // microseconds
+
+private:
+    class BufferingControllerPrivate;
+    QScopedPointer<BufferingControllerPrivate> d_ptr;
+};
+
+} // namespace Ffmpeg
+
+#endif // BUFFERINGCONTROLLER_HPP
@@ -1,5 +1,7 @@
 #include "clock.hpp"
 
+#include <utils/seqlock.hpp>
+
 #include <QDebug>
 #include <QMutex>
 
@@ -9,135 +11,219 @@ extern "C" {
 
 namespace Ffmpeg {
 
+class ClockDomain::ClockDomainPrivate
+{
+public:
+    explicit ClockDomainPrivate(ClockDomain *q)
+        : q_ptr(q)
+    {}
+
+    ClockDomain *q_ptr;
+
+    std::atomic<qint64> serial = 0;
+    std::atomic<double> speed = 1.0;
+    std::atomic<Clock *> master = nullptr;
+    std::atomic<qint64> position = 0;
+};
+
+ClockDomain::ClockDomain(QObject *parent)
+    : QObject{parent}
+    , d_ptr(new ClockDomainPrivate(this))
+{}
+
+ClockDomain::~ClockDomain() = default;
+
+void ClockDomain::serialRef()
+{
+    d_ptr->serial.fetch_add(1);
+}
+
+void ClockDomain::serialReset()
+{
+    d_ptr->serial.store(0);
+}
+
+auto ClockDomain::serial() const -> qint64
+{
+    return d_ptr->serial.load();
+}
+
+void ClockDomain::setSpeed(double value)
+{
+    d_ptr->speed.store(value);
+}
+
+auto ClockDomain::speed() const -> double
+{
+    return d_ptr->speed.load();
+}
+
+void ClockDomain::setMaster(Clock *clock)
+{
+    d_ptr->master.store(clock);
+}
+
+auto ClockDomain::master() const -> Clock *
+{
+    return d_ptr->master.load();
+}
+
+void ClockDomain::setPosition(qint64 position)
+{
+    d_ptr->position.store(position, std::memory_order_relaxed);
+}
+
+auto ClockDomain::position() const -> qint64
+{
+    return d_ptr->position.load(std::memory_order_relaxed);
+}
+
 class Clock::ClockPrivate
 {
 public:
-    explicit ClockPrivate(Clock *q)
+    explicit ClockPrivate(ClockDomain *domain, Clock *q)
         : q_ptr(q)
+        , domain(domain)
+        , state(State{0, 0, 0, domain->serial(), false})
     {}
 
+    struct State
+    {
+        qint64 pts = 0;          // 当前 AVFrame 的时间戳 microseconds
+        qint64 pts_drift = 0;    // 时钟漂移量，用于计算当前时钟的状态 microseconds
+        qint64 last_updated = 0; // 上一次更新时钟状态的时间 microseconds
+        qint64 serial = 0;       // 时钟序列号 for seek
+        bool paused = false;     // 是否暂停播放
+    };
+
+    // writers may run on the display and the audio sink thread, readers never lock
+    template<typename Func>
+    void modify(Func func)
+    {
+        QMutexLocker locker(&writeMutex);
+        auto value = state.load();
+        func(value);
+        state.store(value);
+        if (value.serial == domain->serial() && q_ptr == domain->master()) {
+            domain->setPosition(value.pts);
+        }
+    }
+
     Clock *q_ptr;
+    ClockDomain *domain;
 
-    mutable QMutex mutex;
-    qint64 pts = 0;          // 当前 AVFrame 的时间戳 microseconds
-    qint64 pts_drift = 0;    // 时钟漂移量，用于计算当前时钟的状态 microseconds
-    qint64 last_updated = 0; // 上一次更新时钟状态的时间 microseconds
-    qint64 serial = s_serial.load(); // 时钟序列号 for seek
-    bool paused = false;             // 是否暂停播放
+    QMutex writeMutex;
+    Utils::SeqLock<State> state;
 
-    static std::atomic<qint64> s_serial;
-    static std::atomic<double> s_speed;
     static constexpr auto s_diffThreshold = 100 * 1000; // 100 milliseconds
     // static constexpr auto s_diffThreshold = 200 * 1000; // 200 milliseconds
-    static Clock *s_clock;
 };
 
-std::atomic<qint64> Clock::ClockPrivate::s_serial = 0;
-std::atomic<double> Clock::ClockPrivate::s_speed = 1.0;
-Clock *Clock::ClockPrivate::s_clock = nullptr;
-
-Clock::Clock(QObject *parent)
+Clock::Clock(ClockDomain *domain, QObject *parent)
     : QObject{parent}
-    , d_ptr(new ClockPrivate(this))
-{}
+    , d_ptr(new ClockPrivate(domain, this))
+{
+    Q_ASSERT(domain != nullptr);
+}
 
 Clock::~Clock() = default;
 
 void Clock::reset(qint64 pts)
 {
-    QMutexLocker locker(&d_ptr->mutex);
-    d_ptr->pts = pts;
-    d_ptr->pts_drift = 0;
-    d_ptr->last_updated = av_gettime_relative();
-    d_ptr->serial = Clock::ClockPrivate::s_serial.load();
-    d_ptr->paused = false;
+    auto serial = d_ptr->domain->serial();
+    auto now = av_gettime_relative();
+    d_ptr->modify([&](ClockPrivate::State &state) {
+        state.pts = pts;
+        state.pts_drift = 0;
+        state.last_updated = now;
+        state.serial = serial;
+        state.paused = false;
+    });
 }
 
 void Clock::invalidate()
 {
-    QMutexLocker locker(&d_ptr->mutex);
-    d_ptr->last_updated = 0;
+    d_ptr->modify([](ClockPrivate::State &state) { state.last_updated = 0; });
 }
 
 auto Clock::isVaild() const -> bool
 {
-    QMutexLocker locker(&d_ptr->mutex);
-    return d_ptr->last_updated != 0;
+    return d_ptr->state.load().last_updated != 0;
 }
 
 auto Clock::pts() const -> qint64
 {
-    QMutexLocker locker(&d_ptr->mutex);
-    return d_ptr->pts;
+    return d_ptr->state.load().pts;
 }
 
 auto Clock::ptsDrift() const -> qint64
 {
-    QMutexLocker locker(&d_ptr->mutex);
-    return d_ptr->pts_drift;
+    return d_ptr->state.load().pts_drift;
 }
 
 auto Clock::lastUpdated() const -> qint64
 {
-    QMutexLocker locker(&d_ptr->mutex);
-    return d_ptr->last_updated;
+    return d_ptr->state.load().last_updated;
 }
 
 void Clock::resetSerial()
 {
-    QMutexLocker locker(&d_ptr->mutex);
-    d_ptr->serial = Clock::ClockPrivate::s_serial.load();
+    auto serial = d_ptr->domain->serial();
+    d_ptr->modify([serial](ClockPrivate::State &state) { state.serial = serial; });
 }
 
 auto Clock::serial() const -> qint64
 {
-    QMutexLocker locker(&d_ptr->mutex);
-    return d_ptr->serial;
+    return d_ptr->state.load().serial;
 }
 
 auto Clock::paused() const -> bool
 {
-    QMutexLocker locker(&d_ptr->mutex);
-    return d_ptr->paused;
+    return d_ptr->state.load().paused;
 }
 
 void Clock::setPaused(bool value)
 {
-    QMutexLocker locker(&d_ptr->mutex);
-    d_ptr->paused = value;
-    if (!d_ptr->paused) {
-        d_ptr->last_updated = 0;
-        d_ptr->pts_drift = 0;
-    }
+    d_ptr->modify([value](ClockPrivate::State &state) {
+        state.paused = value;
+        if (!state.paused) {
+            state.last_updated = 0;
+            state.pts_drift = 0;
+        }
+    });
 }
 
 void Clock::update(qint64 pts, qint64 time)
 {
-    Q_ASSERT(Clock::ClockPrivate::s_clock);
-
-    QMutexLocker locker(&d_ptr->mutex);
-    if ((d_ptr->last_updated != 0) && !d_ptr->paused) {
-        if (this == Clock::ClockPrivate::s_clock
-            || Clock::ClockPrivate::s_clock->d_ptr->last_updated == 0) {
-            qint64 timediff = (time - d_ptr->last_updated) * speed();
-            d_ptr->pts_drift += pts - d_ptr->pts - timediff;
-        } else {
-            auto *masterClock = Clock::ClockPrivate::s_clock;
-            auto masterClockPts = masterClock->d_ptr->pts - masterClock->d_ptr->pts_drift;
-            qint64 timediff = (time - masterClock->d_ptr->last_updated) * speed();
-            d_ptr->pts_drift = pts - masterClockPts - timediff;
+    auto *masterClock = d_ptr->domain->master();
+    Q_ASSERT(masterClock);
+
+    auto speed = this->speed();
+    d_ptr->modify([&](ClockPrivate::State &state) {
+        if ((state.last_updated != 0) && !state.paused) {
+            // one consistent snapshot of the master, it is written by another thread
+            auto master = this == masterClock ? state : masterClock->d_ptr->state.load();
+            if (this == masterClock || master.last_updated == 0) {
+                qint64 timediff = (time - state.last_updated) * speed;
+                state.pts_drift += pts - state.pts - timediff;
+            } else {
+                auto masterClockPts = master.pts - master.pts_drift;
+                qint64 timediff = (time - master.last_updated) * speed;
+                state.pts_drift = pts - masterClockPts - timediff;
+            }
         }
-    }
-    d_ptr->pts = pts;
-    d_ptr->last_updated = time;
+        state.pts = pts;
+        state.last_updated = time;
+    });
 }
 
 auto Clock::getDelayWithMaster(qint64 &delay) const -> bool
 {
-    if (serial() != Clock::ClockPrivate::s_serial.load()) {
+    auto state = d_ptr->state.load();
+    if (state.serial != d_ptr->domain->serial()) {
         return false;
     }
-    delay = ptsDrift();
+    delay = state.pts_drift;
     return true;
 }
 
@@ -148,7 +234,7 @@ auto Clock::adjustDelay(qint64 &delay) -> bool
     }
     if (delay < -Clock::ClockPrivate::s_diffThreshold) {
         reset(pts()); // 有可能是因为网络下载过慢导致的延迟，需要重置
-        if (this == Clock::ClockPrivate::s_clock) { // 主时钟不丢帧
+        if (this == d_ptr->domain->master()) { // 主时钟不丢帧
             delay = 0;
             return true;
         }
@@ -162,34 +248,14 @@ auto Clock::adjustDelay(qint64 &delay) -> bool
     return true;
 }
 
-void Clock::globalSerialRef()
-{
-    Clock::ClockPrivate::s_serial.fetch_add(1);
-}
-
-void Clock::globalSerialReset()
-{
-    Clock::ClockPrivate::s_serial.store(0);
-}
-
-void Clock::setSpeed(double value)
-{
-    Clock::ClockPrivate::s_speed.store(value);
-}
-
-auto Clock::speed() -> double
-{
-    return Clock::ClockPrivate::s_speed.load();
-}
-
-void Clock::setMaster(Clock *clock)
+auto Clock::domain() const -> ClockDomain *
 {
-    Clock::ClockPrivate::s_clock = clock;
+    return d_ptr->domain;
 }
 
-auto Clock::master() -> Clock *
+auto Clock::speed() const -> double
 {
-    return Clock::ClockPrivate::s_clock;
+    return d_ptr->domain->speed();
 }
 
 } // namespace Ffmpeg
@@ -5,10 +5,42 @@
 
 namespace Ffmpeg {
 
+class Clock;
+
+// Master clock, playback speed and seek serial shared by the clocks of one Player,
+// players in the same process each own a domain and never see each other's state
+class ClockDomain : public QObject
+{
+public:
+    explicit ClockDomain(QObject *parent = nullptr);
+    ~ClockDomain() override;
+
+    void serialRef();
+    void serialReset();
+    [[nodiscard]] auto serial() const -> qint64;
+
+    void setSpeed(double value);
+    [[nodiscard]] auto speed() const -> double;
+
+    // not delete clock
+    void setMaster(Clock *clock);
+    [[nodiscard]] auto master() const -> Clock *;
+
+    // microseconds, the pts of the master clock, written on every update of it and read
+    // lock-free by Player::position()
+    void setPosition(qint64 position);
+    [[nodiscard]] auto position() const -> qint64;
+
+private:
+    class ClockDomainPrivate;
+    QScopedPointer<ClockDomainPrivate> d_ptr;
+};
+
+// Readers take a consistent snapshot without locking, writers are serialized
 class Clock : public QObject
 {
 public:
-    explicit Clock(QObject *parent = nullptr);
+    explicit Clock(ClockDomain *domain, QObject *parent = nullptr);
     ~Clock() override;
 
     void reset(qint64 pts);
@@ -34,15 +66,8 @@ public:
     // return true if delay is valid
     auto adjustDelay(qint64 &delay) -> bool;
 
-    static void globalSerialRef();
-    static void globalSerialReset();
-
-    static void setSpeed(double value);
-    static auto speed() -> double;
-
-    // not thread safe and not delete clock
-    static void setMaster(Clock *clock);
-    static auto master() -> Clock *;
+    [[nodiscard]] auto domain() const -> ClockDomain *;
+    [[nodiscard]] auto speed() const -> double;
 
 private:
     class ClockPrivate;
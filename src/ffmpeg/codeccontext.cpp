@@ -295,6 +295,14 @@ void CodecContext::setThreadCount(int threadCount)
     d_ptr->codecCtx->thread_count = threadCount;
 }
 
+void CodecContext::setSkip(AVDiscard skipFrame, AVDiscard skipLoopFilter, AVDiscard skipIdct)
+{
+    Q_ASSERT(d_ptr->codecCtx != nullptr);
+    d_ptr->codecCtx->skip_frame = skipFrame;
+    d_ptr->codecCtx->skip_loop_filter = skipLoopFilter;
+    d_ptr->codecCtx->skip_idct = skipIdct;
+}
+
 void CodecContext::setPixfmt(AVPixelFormat pixfmt)
 {
     if (d_ptr->supported_pix_fmts.isEmpty() || d_ptr->supported_pix_fmts.contains(pixfmt)) {
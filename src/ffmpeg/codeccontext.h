@@ -7,6 +7,7 @@
 
 extern "C" {
 #include <libavcodec/codec.h>
+#include <libavcodec/defs.h>
 }
 
 struct AVCodecParameters;
@@ -58,6 +59,9 @@ public:
     void setThreadCount(int threadCount);
     auto open() -> bool;
 
+    // Decoder only, may change between packets, AVDISCARD_DEFAULT decodes everything
+    void setSkip(AVDiscard skipFrame, AVDiscard skipLoopFilter, AVDiscard skipIdct);
+
     auto sendPacket(Packet *packet) -> bool;
     auto receiveFrame(Frame *frame) -> bool;
     auto decodeSubtitle2(Subtitle *subtitle, Packet *packet) -> bool;
@@ -1 +1,62 @@
 #include "decoder.h"
+
+#include <QImage>
+
+namespace Ffmpeg {
+
+auto queueItemBytes(const PacketPtr &packetPtr) -> qint64
+{
+    return packetPtr.isNull() ? 0 : packetPtr->size();
+}
+
+auto queueItemBytes(const FramePtr &framePtr) -> qint64
+{
+    return framePtr.isNull() ? 0 : framePtr->bufferSize();
+}
+
+auto queueItemBytes(const SubtitlePtr &subtitlePtr) -> qint64
+{
+    if (subtitlePtr.isNull()) {
+        return 0;
+    }
+    // graphics subtitles hold a rendered image, ass subtitles their rendered bitmaps
+    qint64 bytes = subtitlePtr->image().sizeInBytes();
+    for (const auto &text : subtitlePtr->texts()) {
+        bytes += text.size();
+    }
+    for (const auto &data : subtitlePtr->list()) {
+        bytes += data.rgba().size();
+    }
+    return bytes;
+}
+
+auto queueItemTimestamp(const PacketPtr &packetPtr, const AVRational &timeBase) -> qint64
+{
+    if (packetPtr.isNull()) {
+        return Utils::s_invalidQueueTimestamp;
+    }
+    // packets are queued before calculatePts, so the timestamps are still in stream time base
+    auto *avPacket = packetPtr->avPacket();
+    auto ts = avPacket->dts == AV_NOPTS_VALUE ? avPacket->pts : avPacket->dts;
+    if (ts == AV_NOPTS_VALUE) {
+        return Utils::s_invalidQueueTimestamp;
+    }
+    return av_rescale_q(ts, timeBase, AVRational{1, AV_TIME_BASE});
+}
+
+auto queueItemTimestamp(const FramePtr &framePtr, const AVRational &timeBase) -> qint64
+{
+    Q_UNUSED(timeBase);
+    if (framePtr.isNull() || framePtr->avFrame()->pts == AV_NOPTS_VALUE) {
+        return Utils::s_invalidQueueTimestamp;
+    }
+    return framePtr->pts();
+}
+
+auto queueItemTimestamp(const SubtitlePtr &subtitlePtr, const AVRational &timeBase) -> qint64
+{
+    Q_UNUSED(timeBase);
+    return subtitlePtr.isNull() ? Utils::s_invalidQueueTimestamp : subtitlePtr->pts();
+}
+
+} // namespace Ffmpeg
@@ -3,24 +3,53 @@
 
 #include <QSharedPointer>
 #include <QThread>
+#include <QWaitCondition>
 
 #include <event/event.hpp>
-#include <utils/boundedblockingqueue.hpp>
+#include <utils/boundedspscqueue.hpp>
 #include <utils/threadsafequeue.hpp>
 
 #include "avcontextinfo.h"
+#include "decoderexecutor.hpp"
 #include "formatcontext.h"
+#include "frame.hpp"
+#include "packet.h"
+#include "subtitle.h"
 
 extern "C" {
 #include <libavformat/avformat.h>
+#include <libavutil/time.h>
 }
 
 namespace Ffmpeg {
 
 static constexpr auto s_waitQueueEmptyMilliseconds = 50;
-static constexpr auto s_videoQueueSize = 10;
+
+struct QueueLimit
+{
+    int maxSize = 0;        // elements, hard upper bound
+    qint64 maxBytes = 0;    // <= 0 means unlimited
+    qint64 maxDuration = 0; // microseconds, <= 0 means unlimited
+};
+
+// Ten 8K frames and ten 480p frames use wildly different amounts of memory, so queues are bounded
+// by bytes and by pts span, the element count only sizes the ring.
+static constexpr QueueLimit s_videoQueueLimit{512, 64 * 1024 * 1024, 2 * AV_TIME_BASE};
 // For truehd audio, the queue size should be large enough
-static constexpr auto s_audioQueueSize = 200;
+static constexpr QueueLimit s_audioQueueLimit{4096, 16 * 1024 * 1024, 2 * AV_TIME_BASE};
+// Subtitles are sparse, a pts span limit would stall the demuxer until the next subtitle is due
+static constexpr QueueLimit s_subtitleQueueLimit{64, 16 * 1024 * 1024, 0};
+// Live audio and video, whatever waits in a queue is latency
+static constexpr QueueLimit s_lowLatencyQueueLimit{32, 16 * 1024 * 1024, AV_TIME_BASE / 10};
+
+auto queueItemBytes(const PacketPtr &packetPtr) -> qint64;
+auto queueItemBytes(const FramePtr &framePtr) -> qint64;
+auto queueItemBytes(const SubtitlePtr &subtitlePtr) -> qint64;
+
+// microseconds, Utils::s_invalidQueueTimestamp if unknown
+auto queueItemTimestamp(const PacketPtr &packetPtr, const AVRational &timeBase) -> qint64;
+auto queueItemTimestamp(const FramePtr &framePtr, const AVRational &timeBase) -> qint64;
+auto queueItemTimestamp(const SubtitlePtr &subtitlePtr, const AVRational &timeBase) -> qint64;
 
 template<typename T>
 class Decoder : public QThread
@@ -28,10 +57,19 @@ class Decoder : public QThread
 public:
     explicit Decoder(QObject *parent = nullptr)
         : QThread(parent)
-        , m_queue(s_videoQueueSize)
+        , m_queue(s_videoQueueLimit.maxSize)
     {}
     ~Decoder() override = default;
 
+    // Task mode: instead of owning a QThread, the stage runs as a resumable task on the shared
+    // DecoderExecutor. Takes effect on the next startDecoder.
+    void setUseSharedExecutor(bool use) { m_useSharedExecutor = use; }
+    [[nodiscard]] auto useSharedExecutor() const -> bool { return m_useSharedExecutor; }
+
+    // Small audio and video queues for live inputs. Takes effect on the next startDecoder.
+    void setLowLatency(bool lowLatency) { m_lowLatency = lowLatency; }
+    [[nodiscard]] auto lowLatency() const -> bool { return m_lowLatency; }
+
     void startDecoder(FormatContext *formatContext, AVContextInfo *contextInfo)
     {
         stopDecoder();
@@ -41,23 +79,35 @@ public:
         if (!m_contextInfo->isIndexVaild()) {
             return;
         }
-        if (m_contextInfo->stream()->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
-            m_queue.setMaxSize(s_audioQueueSize);
-        } else {
-            m_queue.setMaxSize(s_videoQueueSize);
+        setQueueLimit(m_contextInfo->stream()->codecpar->codec_type);
+        m_queue.setNotifyCallbacks([this] { notify(); }, [this] { notifyUpstream(); });
+        if (!m_useSharedExecutor) {
+            start();
+            return;
         }
-        start();
+        onDecoderStarted();
+        m_taskActive.store(true);
+        notify();
     }
 
     virtual void stopDecoder()
     {
         m_runing = false;
-        clear();
-        wakeup();
+        notify();
         if (isRunning()) {
             quit();
             wait();
         }
+        if (m_taskActive.load()) {
+            DecoderExecutor::instance()->cancel(this);
+            waitTaskIdle();
+            onDecoderStopped();
+            // downstream stages may have resumed this task while stopping
+            waitTaskIdle();
+            m_taskActive.store(false);
+        }
+        // the consumer has stopped, so it is safe to drain the queue from this thread
+        clear();
         m_eventQueue.clear();
     }
 
@@ -69,31 +119,64 @@ public:
     void append(T &&t)
     {
         assertVaild();
-        m_queue.append(t);
+        m_queue.append(std::move(t));
+    }
+    // non-blocking, for producers running in task mode
+    auto tryAppend(T &&t) -> bool
+    {
+        assertVaild();
+        return m_queue.tryAppend(std::move(t));
     }
 
     auto size() -> size_t { return m_queue.size(); }
+    auto bytes() -> qint64 { return m_queue.bytes(); }
+    auto duration() -> qint64 { return m_queue.duration(); } // microseconds
 
+    // consumer thread only
     void clear() { m_queue.clear(); }
 
-    void wakeup()
+    // Resume the stage, thread safe
+    void notify()
     {
-        if (m_queue.empty()) {
-            m_queue.insertHead(T());
+        m_notifyCount.fetch_add(1);
+        if (m_taskActive.load()) {
+            if (!m_scheduled.exchange(true)) {
+                DecoderExecutor::instance()->start([this] { runTask(); });
+            }
+            return;
+        }
+        if (m_parked.load()) {
+            QMutexLocker locker(&m_parkMutex);
+            m_parkCondition.wakeOne();
         }
     }
 
+    // called whenever this stage takes from its queue, a producer blocked on a full queue in
+    // task mode resumes from here
+    void setUpstream(std::function<void()> notifyUpstream)
+    {
+        m_notifyUpstream = std::move(notifyUpstream);
+    }
+
     void addEvent(const EventPtr &event)
     {
         if (!m_contextInfo->isIndexVaild()) {
             return;
         }
         m_eventQueue.append(event);
-        wakeup();
+        notify();
     }
 
 protected:
-    virtual void runDecoder() = 0;
+    virtual void onDecoderStarted() {}
+    virtual void onDecoderStopped() {}
+    // Do one unit of work without blocking.
+    // Return false if no progress can be made until the input queue grows, the output queue
+    // shrinks, an event arrives or the deadline set with wakeupAt() is reached.
+    virtual auto runDecoderStep() -> bool = 0;
+
+    // microseconds, av_gettime_relative() based, only valid for the current step
+    void wakeupAt(qint64 time) { m_wakeupTime = time; }
 
     void run() final
     {
@@ -101,7 +184,34 @@ protected:
         if (!m_contextInfo->isIndexVaild()) {
             return;
         }
-        runDecoder();
+        onDecoderStarted();
+        while (m_runing.load()) {
+            auto notified = m_notifyCount.load();
+            m_wakeupTime = 0;
+            if (!runDecoderStep()) {
+                park(notified);
+            }
+        }
+        onDecoderStopped();
+    }
+
+    void setQueueLimit(AVMediaType mediaType)
+    {
+        QueueLimit limit;
+        switch (mediaType) {
+        case AVMEDIA_TYPE_AUDIO: limit = s_audioQueueLimit; break;
+        case AVMEDIA_TYPE_SUBTITLE: limit = s_subtitleQueueLimit; break;
+        default: limit = s_videoQueueLimit; break;
+        }
+        if (m_lowLatency && mediaType != AVMEDIA_TYPE_SUBTITLE) {
+            limit = s_lowLatencyQueueLimit;
+        }
+        m_queue.setMaxSize(limit.maxSize);
+        m_queue.setByteLimit(limit.maxBytes, [](const T &t) { return queueItemBytes(t); });
+        m_queue.setDurationLimit(limit.maxDuration,
+                                 [timeBase = m_contextInfo->timebase()](const T &t) {
+                                     return queueItemTimestamp(t, timeBase);
+                                 });
     }
 
     void assertVaild()
@@ -110,11 +220,96 @@ protected:
         Q_ASSERT(m_contextInfo != nullptr);
     }
 
-    Utils::BoundedBlockingQueue<T> m_queue;
+    // one producer (the upstream stage) and one consumer (this stage)
+    Utils::BoundedSpscQueue<T> m_queue;
     Utils::ThreadSafeQueue<EventPtr> m_eventQueue;
     AVContextInfo *m_contextInfo = nullptr;
     FormatContext *m_formatContext = nullptr;
     std::atomic_bool m_runing = true;
+
+private:
+    // thread mode, sleep until notify() or the step deadline
+    void park(quint64 notified)
+    {
+        QMutexLocker locker(&m_parkMutex);
+        m_parked.store(true);
+        while (m_runing.load() && m_notifyCount.load() == notified) {
+            if (m_wakeupTime == 0) {
+                m_parkCondition.wait(&m_parkMutex);
+                continue;
+            }
+            auto timeout = m_wakeupTime - av_gettime_relative();
+            if (timeout <= 0) {
+                break;
+            }
+            m_parkCondition.wait(&m_parkMutex, (timeout + 999) / 1000);
+        }
+        m_parked.store(false);
+    }
+
+    // task mode, at most one runTask of a stage is scheduled or running at any time
+    void runTask()
+    {
+        while (true) {
+            auto notified = m_notifyCount.load();
+            m_wakeupTime = 0;
+            auto steps = 0;
+            auto progress = false;
+            while (m_runing.load() && (progress = runDecoderStep())) {
+                if (++steps == s_taskStepBatch) {
+                    // give the other stages sharing the pool a turn
+                    DecoderExecutor::instance()->start([this] { runTask(); });
+                    return;
+                }
+            }
+            if (!progress && m_wakeupTime != 0 && m_runing.load()) {
+                DecoderExecutor::instance()->startAt(m_wakeupTime, this, [this] { notify(); });
+            }
+            m_scheduled.store(false);
+            if (m_idleWaiting.load()) {
+                QMutexLocker locker(&m_idleMutex);
+                m_idleCondition.wakeAll();
+            }
+            if (m_notifyCount.load() == notified || m_scheduled.exchange(true)) {
+                return;
+            }
+        }
+    }
+
+    void waitTaskIdle()
+    {
+        QMutexLocker locker(&m_idleMutex);
+        m_idleWaiting.store(true);
+        while (m_scheduled.load()) {
+            m_idleCondition.wait(&m_idleMutex);
+        }
+        m_idleWaiting.store(false);
+    }
+
+    void notifyUpstream()
+    {
+        if (m_notifyUpstream) {
+            m_notifyUpstream();
+        }
+    }
+
+    static constexpr auto s_taskStepBatch = 32;
+
+    bool m_useSharedExecutor = false;
+    bool m_lowLatency = false;
+    std::atomic_bool m_taskActive = false;
+    std::atomic_bool m_scheduled = false;
+    std::atomic<quint64> m_notifyCount = 0;
+    // stopDecoder waiting for the scheduled task to return
+    std::atomic_bool m_idleWaiting = false;
+    QMutex m_idleMutex;
+    QWaitCondition m_idleCondition;
+    qint64 m_wakeupTime = 0;
+    std::function<void()> m_notifyUpstream;
+
+    std::atomic_bool m_parked = false;
+    QMutex m_parkMutex;
+    QWaitCondition m_parkCondition;
 };
 
 } // namespace Ffmpeg
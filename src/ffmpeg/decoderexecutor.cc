@@ -0,0 +1,123 @@
+#include "decoderexecutor.hpp"
+
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include <map>
+
+extern "C" {
+#include <libavutil/time.h>
+}
+
+namespace Ffmpeg {
+
+class DecoderExecutor::DecoderExecutorPrivate
+{
+public:
+    explicit DecoderExecutorPrivate(DecoderExecutor *q)
+        : q_ptr(q)
+    {
+        threadPool = new QThreadPool(q_ptr);
+        threadPool->setMaxThreadCount(QThread::idealThreadCount());
+        threadPool->setExpiryTimeout(-1);
+
+        timerThreadPtr.reset(QThread::create([this] { runTimer(); }));
+        timerThreadPtr->start(QThread::TimeCriticalPriority);
+    }
+
+    ~DecoderExecutorPrivate()
+    {
+        {
+            QMutexLocker locker(&mutex);
+            runing = false;
+            waitCondition.wakeAll();
+        }
+        timerThreadPtr->wait();
+        threadPool->waitForDone();
+    }
+
+    void runTimer()
+    {
+        QMutexLocker locker(&mutex);
+        while (runing) {
+            if (timers.empty()) {
+                waitCondition.wait(&mutex);
+                continue;
+            }
+            auto timeout = timers.begin()->first - av_gettime_relative();
+            if (timeout > 0) {
+                // round up, waking early would only re-arm the same deadline
+                waitCondition.wait(&mutex, (timeout + 999) / 1000);
+                continue;
+            }
+            auto task = std::move(timers.begin()->second.task);
+            timers.erase(timers.begin());
+            // keep the lock, cancel() must not return while a task of its owner is running
+            task();
+        }
+    }
+
+    void removeTimer(const void *owner)
+    {
+        for (auto iter = timers.begin(); iter != timers.end();) {
+            if (iter->second.owner == owner) {
+                iter = timers.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    struct Timer
+    {
+        const void *owner = nullptr;
+        Task task;
+    };
+
+    DecoderExecutor *q_ptr;
+
+    QThreadPool *threadPool;
+
+    QScopedPointer<QThread> timerThreadPtr;
+    QMutex mutex;
+    QWaitCondition waitCondition;
+    std::multimap<qint64, Timer> timers;
+    bool runing = true;
+};
+
+DecoderExecutor::DecoderExecutor(QObject *parent)
+    : QObject{parent}
+    , d_ptr(new DecoderExecutorPrivate(this))
+{}
+
+DecoderExecutor::~DecoderExecutor() = default;
+
+void DecoderExecutor::start(Task task)
+{
+    d_ptr->threadPool->start(std::move(task));
+}
+
+void DecoderExecutor::startAt(qint64 time, const void *owner, Task task)
+{
+    QMutexLocker locker(&d_ptr->mutex);
+    d_ptr->removeTimer(owner);
+    auto iter = d_ptr->timers.emplace(time, DecoderExecutorPrivate::Timer{owner, std::move(task)});
+    if (iter == d_ptr->timers.begin()) {
+        d_ptr->waitCondition.wakeAll();
+    }
+}
+
+void DecoderExecutor::cancel(const void *owner)
+{
+    QMutexLocker locker(&d_ptr->mutex);
+    d_ptr->removeTimer(owner);
+}
+
+auto DecoderExecutor::maxThreadCount() const -> int
+{
+    return d_ptr->threadPool->maxThreadCount();
+}
+
+} // namespace Ffmpeg
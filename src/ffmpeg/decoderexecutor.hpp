@@ -0,0 +1,40 @@
+#ifndef DECODEREXECUTOR_HPP
+#define DECODEREXECUTOR_HPP
+
+#include <utils/singleton.hpp>
+
+#include <functional>
+
+namespace Ffmpeg {
+
+// Shared pool for the decoder/display stages running in task mode, see Decoder<T>.
+// Stages never block inside a task, they return and are resumed by the queue notifications,
+// an event or a deadline armed with startAt().
+class DecoderExecutor : public QObject
+{
+public:
+    using Task = std::function<void()>;
+
+    void start(Task task);
+
+    // time is av_gettime_relative() based, microseconds.
+    // Only the latest deadline of an owner is kept.
+    void startAt(qint64 time, const void *owner, Task task);
+    // No deadline of owner fires after cancel returns
+    void cancel(const void *owner);
+
+    [[nodiscard]] auto maxThreadCount() const -> int;
+
+private:
+    explicit DecoderExecutor(QObject *parent = nullptr);
+    ~DecoderExecutor() override;
+
+    class DecoderExecutorPrivate;
+    QScopedPointer<DecoderExecutorPrivate> d_ptr;
+
+    SINGLETON(DecoderExecutor)
+};
+
+} // namespace Ffmpeg
+
+#endif // DECODEREXECUTOR_HPP
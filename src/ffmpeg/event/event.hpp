@@ -20,7 +20,9 @@ public:
         SeekChanged,
         PreviewFramesChanged,
         AVError,
-        Error
+        Error,
+        BufferHealth,
+        LiveLatency
     };
     Q_ENUM(EventType);
 
@@ -58,7 +60,8 @@ public:
 
         Pause = 100,
         Seek,
-        SeekRelative
+        SeekRelative,
+        Buffering
     };
     Q_ENUM(EventType);
 
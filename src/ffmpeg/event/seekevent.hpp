@@ -20,12 +20,17 @@ public:
     void setPosition(qint64 position) { m_position = position; }
     [[nodiscard]] auto position() const -> qint64 { return m_position; }
 
+    // decoders drop the frames between the keyframe and position instead of showing them
+    void setAccurate(bool accurate) { m_accurate = accurate; }
+    [[nodiscard]] auto isAccurate() const -> bool { return m_accurate; }
+
     void setWaitCountdown(int count) { m_latch.setCount(count); }
     void countDown() { m_latch.countDown(); }
     void wait() { m_latch.wait(); }
 
 private:
     qint64 m_position = 0;
+    bool m_accurate = true;
     Utils::CountDownLatch m_latch;
 };
 
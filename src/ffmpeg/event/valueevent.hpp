@@ -74,6 +74,50 @@ private:
     qint64 m_speed = 0;
 };
 
+class FFMPEG_EXPORT BufferHealthEvent : public PropertyChangeEvent
+{
+public:
+    explicit BufferHealthEvent(qint64 buffered, qint64 target, QObject *parent = nullptr)
+        : PropertyChangeEvent(parent)
+        , m_buffered(buffered)
+        , m_target(target)
+    {}
+
+    [[nodiscard]] auto type() const -> EventType override { return EventType::BufferHealth; }
+
+    // microseconds ahead of playback and the look-ahead aimed for
+    [[nodiscard]] auto buffered() const -> qint64 { return m_buffered; }
+    [[nodiscard]] auto target() const -> qint64 { return m_target; }
+    [[nodiscard]] auto percent() const -> int
+    {
+        return m_target > 0 ? static_cast<int>(qMin(m_buffered * 100 / m_target, qint64(100))) : 0;
+    }
+
+private:
+    qint64 m_buffered = 0;
+    qint64 m_target = 0;
+};
+
+class FFMPEG_EXPORT LiveLatencyEvent : public PropertyChangeEvent
+{
+public:
+    explicit LiveLatencyEvent(qint64 latency, bool glassToGlass, QObject *parent = nullptr)
+        : PropertyChangeEvent(parent)
+        , m_latency(latency)
+        , m_glassToGlass(glassToGlass)
+    {}
+
+    [[nodiscard]] auto type() const -> EventType override { return EventType::LiveLatency; }
+
+    [[nodiscard]] auto latency() const -> qint64 { return m_latency; } // microseconds
+    // from capture by the wallclock of the source, otherwise from receiving the packet
+    [[nodiscard]] auto isGlassToGlass() const -> bool { return m_glassToGlass; }
+
+private:
+    qint64 m_latency = 0;
+    bool m_glassToGlass = false;
+};
+
 class PauseEvent : public Event
 {
 public:
@@ -91,6 +135,23 @@ private:
     bool m_paused = false;
 };
 
+// the displays hold their frames and the audio sink is suspended while buffering
+class BufferingEvent : public Event
+{
+public:
+    explicit BufferingEvent(bool buffering, QObject *parent = nullptr)
+        : Event(parent)
+        , m_buffering(buffering)
+    {}
+
+    [[nodiscard]] auto type() const -> EventType override { return EventType::Buffering; }
+
+    [[nodiscard]] auto buffering() const -> bool { return m_buffering; }
+
+private:
+    bool m_buffering = false;
+};
+
 class FFMPEG_EXPORT GpuEvent : public Event
 {
 public:
@@ -25,22 +25,33 @@ SOURCES += \
     avcontextinfo.cpp \
     averror.cpp \
     averrormanager.cc \
+    bufferingcontroller.cc \
     clock.cc \
     codeccontext.cpp \
     colorutils.cc \
     decoder.cc \
+    decoderexecutor.cc \
     encodecontext.cc \
     ffmpegutils.cc \
     formatcontext.cpp \
     frame.cc \
     hdrmetadata.cc \
+    httpcacheio.cc \
+    imagebufferpool.cc \
+    keyframeindex.cc \
+    mappedfileio.cc \
     mediainfo.cc \
     packet.cpp \
+    packetcache.cc \
+    packetdispatcher.cc \
     player.cpp \
+    prefetchio.cc \
+    presentationscheduler.cc \
     previewtask.cc \
     subtitle.cpp \
     subtitledecoder.cpp \
     subtitledisplay.cc \
+    threadingpolicy.cc \
     transcoder.cc \
     transcodercontext.cc \
     videodecoder.cpp \
@@ -56,23 +67,34 @@ HEADERS += \
     avcontextinfo.h \
     averror.h \
     averrormanager.hpp \
+    bufferingcontroller.hpp \
     clock.hpp \
     codeccontext.h \
     colorutils.hpp \
     decoder.h \
+    decoderexecutor.hpp \
     encodecontext.hpp \
     ffmepg_global.h \
     ffmpegutils.hpp \
     formatcontext.h \
     frame.hpp \
     hdrmetadata.hpp \
+    httpcacheio.hpp \
+    imagebufferpool.hpp \
+    keyframeindex.hpp \
+    mappedfileio.hpp \
     mediainfo.hpp \
     packet.h \
+    packetcache.hpp \
+    packetdispatcher.hpp \
     player.h \
+    prefetchio.hpp \
+    presentationscheduler.hpp \
     previewtask.hpp \
     subtitle.h \
     subtitledecoder.h \
     subtitledisplay.hpp \
+    threadingpolicy.hpp \
     transcoder.hpp \
     transcodercontext.hpp \
     videodecoder.h \
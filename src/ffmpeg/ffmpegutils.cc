@@ -48,6 +48,14 @@ void calculatePts(Packet *packet, AVContextInfo *contextInfo)
     // qDebug() << "Packet duration:" << duration << "pts:" << pts << "tb:" << tb.num << tb.den;
 }
 
+auto rescaleToMicroseconds(qint64 timestamp, const AVRational &timeBase) -> qint64
+{
+    if (timestamp == AV_NOPTS_VALUE) {
+        return AV_NOPTS_VALUE;
+    }
+    return av_rescale_q(timestamp, timeBase, AVRational{1, AV_TIME_BASE});
+}
+
 auto compare_codec_desc(const void *a, const void *b) -> int
 {
     const auto *da = static_cast<const AVCodecDescriptor *const *>(a);
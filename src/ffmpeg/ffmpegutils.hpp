@@ -24,6 +24,8 @@ void FFMPEG_EXPORT printFfmpegInfo();
 
 void calculatePts(Frame *frame, AVContextInfo *contextInfo, FormatContext *formatContext);
 void calculatePts(Packet *packet, AVContextInfo *contextInfo);
+// microseconds, AV_NOPTS_VALUE stays as is, for packets that must keep their stream time base
+auto FFMPEG_EXPORT rescaleToMicroseconds(qint64 timestamp, const AVRational &timeBase) -> qint64;
 
 auto getCurrentHWDeviceTypes() -> QVector<AVHWDeviceType>;
 
@@ -2,6 +2,7 @@
 #define FILTER_HPP
 
 #include <ffmpeg/colorutils.hpp>
+#include <ffmpeg/frame.hpp>
 #include <mediaconfig/equalizer.hpp>
 #include <videorender/tonemapping.hpp>
 
@@ -13,7 +14,6 @@ extern "C" {
 
 namespace Ffmpeg {
 
-class Frame;
 class FilterContext;
 class Filter : public QObject
 {
@@ -30,7 +30,7 @@ public:
     // Audio is "anull"
     void config(const QString &filterSpec);
 
-    auto filterFrame(Frame *frame) -> QVector<QSharedPointer<Frame>>;
+    auto filterFrame(Frame *frame) -> QVector<FramePtr>;
 
     auto buffersinkCtx() -> FilterContext *;
 
@@ -1,11 +1,15 @@
 #include "formatcontext.h"
 #include "averrormanager.hpp"
 #include "ffmpegutils.hpp"
+#include "httpcacheio.hpp"
+#include "mappedfileio.hpp"
 #include "packet.h"
+#include "prefetchio.hpp"
 
 #include <QDebug>
 #include <QImage>
 #include <QTime>
+#include <QUrl>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -13,6 +17,12 @@ extern "C" {
 
 namespace Ffmpeg {
 
+// probing of live inputs, enough for the codec parameters of a keyframe
+static constexpr auto s_lowLatencyProbeSize = 32 * 1024;
+static constexpr auto s_lowLatencyAnalyzeDuration = AV_TIME_BASE / 10;
+// reorder window of rtp based demuxers
+static constexpr auto s_lowLatencyMaxDelay = AV_TIME_BASE / 20;
+
 static void queryStreamInfo(int bestIndex, StreamInfo &streamInfo, StreamInfos &streamInfos)
 {
     if (bestIndex == streamInfo.index) {
@@ -74,6 +84,70 @@ public:
         return av_find_best_stream(formatCtx, type, -1, -1, nullptr, 0);
     }
 
+    // Reads through a custom AVIOContext when one fits and is asked for: the prefetch ring, else
+    // the disk cache for http(s) or a mapping of local files. Protocols avio cannot open, like
+    // rtsp, are left to the demuxer.
+    void setupCustomIO(const QByteArray &inpuUrl)
+    {
+        AVIOContext *avioContext = nullptr;
+        if (prefetchSize > 0) {
+            prefetchIO.reset(new PrefetchIO(prefetchSize));
+            if (prefetchIO->open(inpuUrl)) {
+                avioContext = prefetchIO->avioContext();
+            } else {
+                prefetchIO.reset();
+            }
+        } else if (httpCache && HttpCacheIO::isCacheable(filepath)) {
+            httpCacheIO.reset(new HttpCacheIO);
+            if (httpCacheIO->open(inpuUrl)) {
+                avioContext = httpCacheIO->avioContext();
+            } else {
+                httpCacheIO.reset();
+            }
+        } else if (auto url = QUrl::fromUserInput(filepath); memoryMapping && url.isLocalFile()) {
+            mappedFileIO.reset(new MappedFileIO);
+            if (mappedFileIO->open(url.toLocalFile())) {
+                avioContext = mappedFileIO->avioContext();
+            } else {
+                mappedFileIO.reset();
+            }
+        }
+        if (avioContext == nullptr) {
+            return;
+        }
+        formatCtx = avformat_alloc_context();
+        formatCtx->pb = avioContext;
+        formatCtx->flags |= AVFMT_FLAG_CUSTOM_IO;
+    }
+
+    void resetCustomIO()
+    {
+        prefetchIO.reset();
+        httpCacheIO.reset();
+        mappedFileIO.reset();
+    }
+
+    // Jump to the indexed keyframe at or before timestamp. Containers without a usable index,
+    // like mpegts, are positioned by byte offset, the others get the exact keyframe pts.
+    auto seekKeyframe(qint64 timestamp) -> bool
+    {
+        if (keyframeIndex.isNull() || indexedStream < 0) {
+            return false;
+        }
+        KeyframeIndex::Entry entry;
+        if (!keyframeIndex->find(indexedStream, timestamp, entry)) {
+            return false;
+        }
+        const auto flags = formatCtx->iformat->flags;
+        if ((flags & AVFMT_NO_BYTE_SEEK) == 0 && (flags & AVFMT_TS_DISCONT) != 0) {
+            if (av_seek_frame(formatCtx, -1, entry.pos, AVSEEK_FLAG_BYTE) >= 0) {
+                return true;
+            }
+        }
+        return avformat_seek_file(formatCtx, -1, entry.pts - seekOffset, entry.pts, timestamp, 0)
+               >= 0;
+    }
+
     FormatContext *q_ptr;
 
     AVFormatContext *formatCtx = nullptr;
@@ -86,6 +160,17 @@ public:
     StreamInfos subtitleTracks;
     StreamInfos attachmentTracks;
 
+    KeyframeIndexPtr keyframeIndex;
+    int indexedStream = -1;
+
+    bool lowLatency = false;
+    qint64 prefetchSize = 0;
+    bool memoryMapping = false;
+    bool httpCache = false;
+    QScopedPointer<PrefetchIO> prefetchIO;
+    QScopedPointer<HttpCacheIO> httpCacheIO;
+    QScopedPointer<MappedFileIO> mappedFileIO;
+
     const qint64 seekOffset = 2 * AV_TIME_BASE;
 };
 
@@ -154,12 +239,24 @@ auto FormatContext::openFilePath(const QString &filepath, OpenMode mode) -> bool
     auto inpuUrl = convertUrlToFfmpegInput(d_ptr->filepath);
     switch (mode) {
     case ReadOnly: {
-        auto ret = avformat_open_input(&d_ptr->formatCtx, inpuUrl.constData(), nullptr, nullptr);
+        AVDictionary *options = nullptr;
+        if (d_ptr->lowLatency) {
+            av_dict_set(&options, "fflags", "nobuffer", 0);
+            av_dict_set_int(&options, "probesize", s_lowLatencyProbeSize, 0);
+            av_dict_set_int(&options, "analyzeduration", s_lowLatencyAnalyzeDuration, 0);
+            av_dict_set_int(&options, "max_delay", s_lowLatencyMaxDelay, 0);
+        } else {
+            d_ptr->setupCustomIO(inpuUrl);
+        }
+        auto ret = avformat_open_input(&d_ptr->formatCtx, inpuUrl.constData(), nullptr, &options);
+        av_dict_free(&options);
         if (ret != 0) {
+            d_ptr->resetCustomIO();
             SET_ERROR_CODE(ret);
             return false;
         }
         av_format_inject_global_side_data(d_ptr->formatCtx);
+        d_ptr->keyframeIndex = KeyframeIndex::forFile(d_ptr->filepath);
         d_ptr->isOpen = true;
     } break;
     case WriteOnly: {
@@ -188,6 +285,9 @@ void FormatContext::close()
     case ReadOnly:
         avformat_close_input(&d_ptr->formatCtx);
         d_ptr->formatCtx = nullptr;
+        d_ptr->resetCustomIO();
+        d_ptr->keyframeIndex.reset();
+        d_ptr->indexedStream = -1;
         d_ptr->isOpen = false;
         break;
     case WriteOnly: avioClose(); break;
@@ -254,6 +354,10 @@ auto FormatContext::findStream() -> bool
         d_ptr->formatCtx->pb->eof_reached = 0;
     }
     d_ptr->initStreamInfo();
+    d_ptr->indexedStream = d_ptr->findBestStreamIndex(AVMEDIA_TYPE_VIDEO);
+    if (!d_ptr->keyframeIndex.isNull() && d_ptr->indexedStream >= 0) {
+        d_ptr->keyframeIndex->importStream(d_ptr->formatCtx->streams[d_ptr->indexedStream]);
+    }
     return true;
 }
 
@@ -317,7 +421,12 @@ auto FormatContext::createStream() -> AVStream *
 auto FormatContext::readFrame(Packet *packet) -> bool
 {
     Q_ASSERT(d_ptr->formatCtx != nullptr);
-    int ret = av_read_frame(d_ptr->formatCtx, packet->avPacket());
+    auto *avPacket = packet->avPacket();
+    int ret = av_read_frame(d_ptr->formatCtx, avPacket);
+    if (ret >= 0 && !d_ptr->keyframeIndex.isNull()
+        && avPacket->stream_index == d_ptr->indexedStream) {
+        d_ptr->keyframeIndex->record(d_ptr->formatCtx->streams[avPacket->stream_index], avPacket);
+    }
     ERROR_RETURN(ret)
 }
 
@@ -367,6 +476,9 @@ auto FormatContext::seek(qint64 timestamp) -> bool
 {
     Q_ASSERT(d_ptr->formatCtx != nullptr);
     Q_ASSERT(timestamp >= 0);
+    if (d_ptr->seekKeyframe(timestamp)) {
+        return true;
+    }
     auto seekMin = timestamp - d_ptr->seekOffset;
     auto seekMax = timestamp + d_ptr->seekOffset;
     auto ret = avformat_seek_file(d_ptr->formatCtx, -1, seekMin, timestamp, seekMax, 0);
@@ -377,6 +489,9 @@ auto FormatContext::seek(qint64 timestamp, bool forward) -> bool
 {
     Q_ASSERT(d_ptr->formatCtx != nullptr);
     Q_ASSERT(timestamp >= 0);
+    if (d_ptr->seekKeyframe(timestamp)) {
+        return true;
+    }
     auto seekMin = forward ? INT64_MIN : timestamp - d_ptr->seekOffset;
     auto seekMax = forward ? timestamp + d_ptr->seekOffset : INT64_MAX;
     auto ret = avformat_seek_file(d_ptr->formatCtx, -1, seekMin, timestamp, seekMax, 0);
@@ -390,6 +505,56 @@ auto FormatContext::seekFrame(int index, qint64 timestamp) -> bool
     ERROR_RETURN(ret)
 }
 
+void FormatContext::setKeyframeIndex(const KeyframeIndexPtr &keyframeIndex)
+{
+    d_ptr->keyframeIndex = keyframeIndex;
+}
+
+auto FormatContext::keyframeIndex() const -> KeyframeIndexPtr
+{
+    return d_ptr->keyframeIndex;
+}
+
+void FormatContext::setLowLatency(bool lowLatency)
+{
+    d_ptr->lowLatency = lowLatency;
+}
+
+auto FormatContext::lowLatency() const -> bool
+{
+    return d_ptr->lowLatency;
+}
+
+void FormatContext::setPrefetchSize(qint64 bytes)
+{
+    d_ptr->prefetchSize = qMax(bytes, qint64(0));
+}
+
+auto FormatContext::prefetchSize() const -> qint64
+{
+    return d_ptr->prefetchSize;
+}
+
+void FormatContext::setMemoryMapping(bool memoryMapping)
+{
+    d_ptr->memoryMapping = memoryMapping;
+}
+
+auto FormatContext::memoryMapping() const -> bool
+{
+    return d_ptr->memoryMapping;
+}
+
+void FormatContext::setHttpCache(bool httpCache)
+{
+    d_ptr->httpCache = httpCache;
+}
+
+auto FormatContext::httpCache() const -> bool
+{
+    return d_ptr->httpCache;
+}
+
 void FormatContext::dumpFormat()
 {
     Q_ASSERT(d_ptr->formatCtx != nullptr);
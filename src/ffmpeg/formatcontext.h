@@ -2,6 +2,7 @@
 #define FORMATCONTEXT_H
 
 #include "ffmepg_global.h"
+#include "keyframeindex.hpp"
 #include "mediainfo.hpp"
 
 #include <QObject>
@@ -56,6 +57,31 @@ public:
     auto seek(qint64 timestamp, bool forward) -> bool;   // microsecond
     auto seekFrame(int index, qint64 timestamp) -> bool; // microsecond
 
+    // Keyframes of the best video stream, attached on open for local files, recorded by
+    // readFrame and used by seek
+    void setKeyframeIndex(const KeyframeIndexPtr &keyframeIndex);
+    [[nodiscard]] auto keyframeIndex() const -> KeyframeIndexPtr;
+
+    // Bytes read ahead on a separate thread by a custom AVIOContext, 0 reads in the demuxer's
+    // thread. Takes effect on the next openFilePath
+    void setPrefetchSize(qint64 bytes);
+    [[nodiscard]] auto prefetchSize() const -> qint64;
+
+    // Local files are read through a memory mapping when not prefetched, off by default, a file
+    // truncated while it is played crashes with SIGBUS. Takes effect on the next openFilePath
+    void setMemoryMapping(bool memoryMapping);
+    [[nodiscard]] auto memoryMapping() const -> bool;
+
+    // http(s) resources are kept in the HttpCacheIO disk cache when not prefetched, off by
+    // default, entries are only keyed by url and length. Takes effect on the next openFilePath
+    void setHttpCache(bool httpCache);
+    [[nodiscard]] auto httpCache() const -> bool;
+
+    // Live inputs: minimal probing, no demuxer buffering and no custom AVIOContext.
+    // Takes effect on the next openFilePath
+    void setLowLatency(bool lowLatency);
+    [[nodiscard]] auto lowLatency() const -> bool;
+
     auto readFrame(Packet *packet) -> bool;
 
     auto checkPktPlayRange(Packet *packet) -> bool;
@@ -13,62 +13,33 @@ extern "C" {
 
 namespace Ffmpeg {
 
-class Frame::FramePrivate
-{
-public:
-    explicit FramePrivate(Frame *q)
-        : q_ptr(q)
-    {}
-    ~FramePrivate() { destroyFrame(); }
-
-    void destroyFrame()
-    {
-        freeImageAlloc();
-        av_frame_free(&frame);
-    }
-
-    void freeImageAlloc()
-    {
-        if (imageAlloc) {
-            av_freep(&frame->data[0]);
-            imageAlloc = false;
-        }
-    }
-
-    Frame *q_ptr;
-
-    AVFrame *frame = nullptr;
-    bool imageAlloc = false;
-};
-
 Frame::Frame()
-    : d_ptr(new FramePrivate(this))
-{
-    d_ptr->frame = av_frame_alloc();
-}
+    : m_frame(av_frame_alloc())
+{}
 
 Frame::Frame(const Frame &other)
-    : d_ptr(new FramePrivate(this))
+    : Utils::RefCounted<Frame>(other)
+    , m_frame(av_frame_alloc())
 {
-    d_ptr->frame = av_frame_alloc();
-    av_frame_ref(d_ptr->frame, other.d_ptr->frame);
+    av_frame_ref(m_frame, other.m_frame);
 }
 
 Frame::Frame(Frame &&other) noexcept
-    : d_ptr(new FramePrivate(this))
+    : m_frame(std::exchange(other.m_frame, nullptr))
+    , m_imageAlloc(std::exchange(other.m_imageAlloc, false))
+{}
+
+Frame::~Frame()
 {
-    d_ptr->frame = other.d_ptr->frame;
-    other.d_ptr->frame = nullptr;
+    destroyFrame();
 }
 
-Frame::~Frame() = default;
-
 auto Frame::operator=(const Frame &other) -> Frame &
 {
     if (this != &other) {
-        d_ptr->freeImageAlloc();
-        av_frame_unref(d_ptr->frame);
-        av_frame_ref(d_ptr->frame, other.d_ptr->frame);
+        freeImageAlloc();
+        av_frame_unref(m_frame);
+        av_frame_ref(m_frame, other.m_frame);
     }
 
     return *this;
@@ -77,9 +48,9 @@ auto Frame::operator=(const Frame &other) -> Frame &
 auto Frame::operator=(Frame &&other) noexcept -> Frame &
 {
     if (this != &other) {
-        d_ptr->freeImageAlloc();
-        d_ptr->frame = other.d_ptr->frame;
-        other.d_ptr->frame = nullptr;
+        destroyFrame();
+        m_frame = std::exchange(other.m_frame, nullptr);
+        m_imageAlloc = std::exchange(other.m_imageAlloc, false);
     }
 
     return *this;
@@ -90,14 +61,14 @@ auto Frame::compareProps(Frame *other) -> bool
     Q_ASSERT(other != nullptr);
     auto *otherFrame = other->avFrame();
     Q_ASSERT(otherFrame != nullptr);
-    Q_ASSERT(d_ptr->frame != nullptr);
+    Q_ASSERT(m_frame != nullptr);
 
-    return d_ptr->frame->width == otherFrame->width && d_ptr->frame->height == otherFrame->height
-           && d_ptr->frame->format == otherFrame->format
-           && compareAVRational(d_ptr->frame->time_base, otherFrame->time_base)
-           && compareAVRational(d_ptr->frame->sample_aspect_ratio, otherFrame->sample_aspect_ratio)
-           && d_ptr->frame->sample_rate == otherFrame->sample_rate
-           && av_channel_layout_compare(&d_ptr->frame->ch_layout, &otherFrame->ch_layout) == 0;
+    return m_frame->width == otherFrame->width && m_frame->height == otherFrame->height
+           && m_frame->format == otherFrame->format
+           && compareAVRational(m_frame->time_base, otherFrame->time_base)
+           && compareAVRational(m_frame->sample_aspect_ratio, otherFrame->sample_aspect_ratio)
+           && m_frame->sample_rate == otherFrame->sample_rate
+           && av_channel_layout_compare(&m_frame->ch_layout, &otherFrame->ch_layout) == 0;
 }
 
 void Frame::copyPropsFrom(Frame *src)
@@ -105,30 +76,30 @@ void Frame::copyPropsFrom(Frame *src)
     Q_ASSERT(src != nullptr);
     auto *srcFrame = src->avFrame();
     Q_ASSERT(srcFrame != nullptr);
-    Q_ASSERT(d_ptr->frame != nullptr);
+    Q_ASSERT(m_frame != nullptr);
 
-    av_frame_copy_props(d_ptr->frame, srcFrame);
-    d_ptr->frame->pts = srcFrame->pts;
-    d_ptr->frame->duration = srcFrame->duration;
-    d_ptr->frame->pict_type = srcFrame->pict_type;
-    d_ptr->frame->flags = srcFrame->flags;
-    d_ptr->frame->width = srcFrame->width;
-    d_ptr->frame->height = srcFrame->height;
-    d_ptr->frame->time_base = srcFrame->time_base;
-    d_ptr->frame->sample_aspect_ratio = srcFrame->sample_aspect_ratio;
-    d_ptr->frame->sample_rate = srcFrame->sample_rate;
-    d_ptr->frame->ch_layout = srcFrame->ch_layout;
+    av_frame_copy_props(m_frame, srcFrame);
+    m_frame->pts = srcFrame->pts;
+    m_frame->duration = srcFrame->duration;
+    m_frame->pict_type = srcFrame->pict_type;
+    m_frame->flags = srcFrame->flags;
+    m_frame->width = srcFrame->width;
+    m_frame->height = srcFrame->height;
+    m_frame->time_base = srcFrame->time_base;
+    m_frame->sample_aspect_ratio = srcFrame->sample_aspect_ratio;
+    m_frame->sample_rate = srcFrame->sample_rate;
+    m_frame->ch_layout = srcFrame->ch_layout;
 }
 
 auto Frame::imageAlloc(const QSize &size, AVPixelFormat pix_fmt, int align) -> bool
 {
-    Q_ASSERT(d_ptr->frame != nullptr);
+    Q_ASSERT(m_frame != nullptr);
     Q_ASSERT(size.width() > 0);
     Q_ASSERT(size.height() > 0);
     Q_ASSERT(pix_fmt != AV_PIX_FMT_NONE);
 
-    auto ret = av_image_alloc(d_ptr->frame->data,
-                              d_ptr->frame->linesize,
+    auto ret = av_image_alloc(m_frame->data,
+                              m_frame->linesize,
                               size.width(),
                               size.height(),
                               pix_fmt,
@@ -138,86 +109,105 @@ auto Frame::imageAlloc(const QSize &size, AVPixelFormat pix_fmt, int align) -> b
         return false;
     }
 
-    d_ptr->imageAlloc = true;
+    m_imageAlloc = true;
     return true;
 }
 
 void Frame::freeImageAlloc()
 {
-    d_ptr->freeImageAlloc();
+    if (m_imageAlloc) {
+        av_freep(&m_frame->data[0]);
+        m_imageAlloc = false;
+    }
 }
 
 void Frame::setPictType(AVPictureType type)
 {
-    d_ptr->frame->pict_type = type;
+    m_frame->pict_type = type;
 }
 
 void Frame::unref()
 {
-    av_frame_unref(d_ptr->frame);
+    av_frame_unref(m_frame);
 }
 
 void Frame::setPts(qint64 pts)
 {
-    d_ptr->frame->pts = pts;
+    m_frame->pts = pts;
 }
 
 auto Frame::pts() -> qint64
 {
-    return d_ptr->frame->pts;
+    return m_frame->pts;
 }
 
 void Frame::setDuration(qint64 duration)
 {
-    d_ptr->frame->duration = duration;
+    m_frame->duration = duration;
 }
 
 auto Frame::duration() -> qint64
 {
-    return d_ptr->frame->duration;
+    return m_frame->duration;
+}
+
+auto Frame::bufferSize() -> qint64
+{
+    Q_ASSERT(m_frame != nullptr);
+    qint64 size = 0;
+    for (auto *buf : m_frame->buf) {
+        if (buf != nullptr) {
+            size += buf->size;
+        }
+    }
+    for (int i = 0; i < m_frame->nb_extended_buf; i++) {
+        size += m_frame->extended_buf[i]->size;
+    }
+    return size;
 }
 
 void Frame::destroyFrame()
 {
-    d_ptr->destroyFrame();
+    freeImageAlloc();
+    av_frame_free(&m_frame);
 }
 
 auto Frame::toImage() -> QImage
 {
-    Q_ASSERT(d_ptr->frame != nullptr);
-    Q_ASSERT(d_ptr->frame->data[0] != nullptr);
-    Q_ASSERT(d_ptr->frame->width > 0);
-    Q_ASSERT(d_ptr->frame->height > 0);
-    Q_ASSERT(d_ptr->frame->format != AV_PIX_FMT_NONE);
+    Q_ASSERT(m_frame != nullptr);
+    Q_ASSERT(m_frame->data[0] != nullptr);
+    Q_ASSERT(m_frame->width > 0);
+    Q_ASSERT(m_frame->height > 0);
+    Q_ASSERT(m_frame->format != AV_PIX_FMT_NONE);
 
-    auto format = VideoFormat::qFormatMaps.value(static_cast<AVPixelFormat>(d_ptr->frame->format),
+    auto format = VideoFormat::qFormatMaps.value(static_cast<AVPixelFormat>(m_frame->format),
                                                  QImage::Format_Invalid);
     if (format == QImage::Format_Invalid) {
         return {};
     }
 
-    QImage image(d_ptr->frame->data[0],
-                 d_ptr->frame->width,
-                 d_ptr->frame->height,
-                 d_ptr->frame->linesize[0],
+    QImage image(m_frame->data[0],
+                 m_frame->width,
+                 m_frame->height,
+                 m_frame->linesize[0],
                  format);
     return image;
 }
 
 auto Frame::getBuffer() -> bool
 {
-    auto ret = av_frame_get_buffer(d_ptr->frame, 0);
+    auto ret = av_frame_get_buffer(m_frame, 0);
     ERROR_RETURN(ret)
 }
 
 auto Frame::isKey() -> bool
 {
-    return d_ptr->frame->flags == AV_FRAME_FLAG_KEY;
+    return m_frame->flags == AV_FRAME_FLAG_KEY;
 }
 
 auto Frame::avFrame() -> AVFrame *
 {
-    return d_ptr->frame;
+    return m_frame;
 }
 
 auto Frame::fromQImage(const QImage &image) -> Frame *
@@ -2,6 +2,9 @@
 
 #include "ffmepg_global.h"
 
+#include <utils/intrusiveref.hpp>
+#include <utils/objectpool.hpp>
+
 #include <QImage>
 #include <QSharedPointer>
 
@@ -14,7 +17,8 @@ struct AVFrame;
 
 namespace Ffmpeg {
 
-class FFMPEG_EXPORT Frame
+// Holds the AVFrame directly and carries its own reference count, a FrameRef is a single pointer
+class FFMPEG_EXPORT Frame : public Utils::RefCounted<Frame>
 {
 public:
     Frame();
@@ -45,6 +49,9 @@ public:
     void setDuration(qint64 duration); // microseconds
     auto duration() -> qint64;
 
+    // bytes held by the referenced buffers
+    auto bufferSize() -> qint64;
+
     auto toImage() -> QImage; // maybe null
 
     auto getBuffer() -> bool;
@@ -56,10 +63,26 @@ public:
     static auto fromQImage(const QImage &image) -> Frame *;
 
 private:
-    class FramePrivate;
-    QScopedPointer<FramePrivate> d_ptr;
+    AVFrame *m_frame = nullptr;
+    bool m_imageAlloc = false;
 };
 
-using FramePtr = QSharedPointer<Frame>;
+using FrameRef = Utils::IntrusiveRef<Frame>;
+using FramePtr = FrameRef;
+
+// Frames handed out are empty, their buffers are released and the Frame is returned to the pool
+// when the last FrameRef drops
+class FramePool : public Utils::ObjectPool<Frame>
+{
+public:
+    explicit FramePool(int maxCached = 64)
+        : Utils::ObjectPool<Frame>(
+            [](Frame *frame) {
+                frame->freeImageAlloc();
+                frame->unref();
+            },
+            maxCached)
+    {}
+};
 
 } // namespace Ffmpeg
@@ -14,11 +14,10 @@ extern "C" {
 
 namespace Ffmpeg {
 
-AVPixelFormat hw_pix_fmt = AV_PIX_FMT_NONE;
-
+// ctx->opaque is the HardWareDecode that owns the device, so every decoder gets its own format
 auto get_hw_format(AVCodecContext *ctx, const enum AVPixelFormat *pix_fmts) -> AVPixelFormat
 {
-    Q_UNUSED(ctx)
+    auto hw_pix_fmt = static_cast<HardWareDecode *>(ctx->opaque)->hwPixelFormat();
     const enum AVPixelFormat *p;
     for (p = pix_fmts; *p != -1; p++) {
         if (*p == hw_pix_fmt) {
@@ -38,10 +37,10 @@ public:
         bufferRef = new BufferRef(q_ptr);
     }
 
-    ~HardWareDecodePrivate() { hw_pix_fmt = AV_PIX_FMT_NONE; }
-
     HardWareDecode *q_ptr;
 
+    AVPixelFormat hw_pix_fmt = AV_PIX_FMT_NONE;
+
     QVector<AVHWDeviceType> hwDeviceTypes = getCurrentHWDeviceTypes();
     AVHWDeviceType hwDeviceType = AV_HWDEVICE_TYPE_NONE;
     BufferRef *bufferRef;
@@ -64,18 +63,18 @@ auto HardWareDecode::initPixelFormat(const AVCodec *decoder) -> bool
         return false;
     }
     for (AVHWDeviceType type : std::as_const(d_ptr->hwDeviceTypes)) {
-        hw_pix_fmt = getPixelFormat(decoder, type);
-        if (hw_pix_fmt != AV_PIX_FMT_NONE) {
+        d_ptr->hw_pix_fmt = getPixelFormat(decoder, type);
+        if (d_ptr->hw_pix_fmt != AV_PIX_FMT_NONE) {
             d_ptr->hwDeviceType = type;
             break;
         }
     }
-    return (hw_pix_fmt != AV_PIX_FMT_NONE);
+    return (d_ptr->hw_pix_fmt != AV_PIX_FMT_NONE);
 }
 
 auto HardWareDecode::initHardWareDevice(CodecContext *codecContext) -> bool
 {
-    if (hw_pix_fmt == AV_PIX_FMT_NONE) {
+    if (d_ptr->hw_pix_fmt == AV_PIX_FMT_NONE) {
         return false;
     }
     if (!d_ptr->bufferRef->hwdeviceCtxCreate(d_ptr->hwDeviceType)) {
@@ -83,22 +82,23 @@ auto HardWareDecode::initHardWareDevice(CodecContext *codecContext) -> bool
     }
     auto *ctx = codecContext->avCodecCtx();
     ctx->hw_device_ctx = d_ptr->bufferRef->ref();
+    ctx->opaque = this;
     ctx->get_format = get_hw_format;
     d_ptr->vaild = ctx->hw_device_ctx != nullptr;
     return d_ptr->vaild;
 }
 
-auto HardWareDecode::transFromGpu(const QSharedPointer<Frame> &inPtr, bool &ok)
-    -> QSharedPointer<Frame>
+auto HardWareDecode::transFromGpu(const FramePtr &inPtr, FramePool &framePool, bool &ok)
+    -> FramePtr
 {
     ok = true;
     if (!isVaild()) {
         return inPtr;
     }
-    if (inPtr->avFrame()->format != hw_pix_fmt) {
+    if (inPtr->avFrame()->format != d_ptr->hw_pix_fmt) {
         return inPtr;
     }
-    FramePtr outPtr(new Frame);
+    auto outPtr = framePool.acquire();
     // 超级吃CPU 巨慢
     auto ret = av_hwframe_transfer_data(outPtr->avFrame(), inPtr->avFrame(), 0);
     // 如果把映射后的帧存起来，接下去解码会出问题；
@@ -120,10 +120,15 @@ auto HardWareDecode::isVaild() -> bool
     if (d_ptr->hwDeviceType == AV_HWDEVICE_TYPE_NONE) {
         return false;
     }
-    if (hw_pix_fmt == AV_PIX_FMT_NONE) {
+    if (d_ptr->hw_pix_fmt == AV_PIX_FMT_NONE) {
         return false;
     }
     return d_ptr->vaild;
 }
 
+auto HardWareDecode::hwPixelFormat() const -> AVPixelFormat
+{
+    return d_ptr->hw_pix_fmt;
+}
+
 } // namespace Ffmpeg
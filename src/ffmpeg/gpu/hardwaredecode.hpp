@@ -1,13 +1,18 @@
 #ifndef HARDWAREDECODE_HPP
 #define HARDWAREDECODE_HPP
 
+#include <ffmpeg/frame.hpp>
+
 #include <QObject>
 
+extern "C" {
+#include <libavutil/pixfmt.h>
+}
+
 struct AVCodec;
 
 namespace Ffmpeg {
 
-class Frame;
 class CodecContext;
 class HardWareDecode : public QObject
 {
@@ -17,10 +22,13 @@ public:
 
     auto initPixelFormat(const AVCodec *decoder) -> bool;
     auto initHardWareDevice(CodecContext *codecContext) -> bool;
-    auto transFromGpu(const QSharedPointer<Frame> &inPtr, bool &ok) -> QSharedPointer<Frame>;
+    // the system memory frame is taken from framePool
+    auto transFromGpu(const FramePtr &inPtr, FramePool &framePool, bool &ok) -> FramePtr;
 
     auto isVaild() -> bool;
 
+    [[nodiscard]] auto hwPixelFormat() const -> AVPixelFormat;
+
 private:
     class HardWareDecodePrivate;
     QScopedPointer<HardWareDecodePrivate> d_ptr;
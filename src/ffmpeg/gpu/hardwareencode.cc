@@ -101,8 +101,10 @@ auto HardWareEncode::initHardWareDevice(CodecContext *codecContext) -> bool
     return d_ptr->vaild;
 }
 
-auto HardWareEncode::transToGpu(CodecContext *codecContext, QSharedPointer<Frame> inPtr, bool &ok)
-    -> QSharedPointer<Frame>
+auto HardWareEncode::transToGpu(CodecContext *codecContext,
+                                FramePtr inPtr,
+                                FramePool &framePool,
+                                bool &ok) -> FramePtr
 {
     ok = true;
     if (!isVaild()) {
@@ -110,7 +112,7 @@ auto HardWareEncode::transToGpu(CodecContext *codecContext, QSharedPointer<Frame
     }
     auto *avctx = codecContext->avCodecCtx();
     auto *sw_frame = inPtr->avFrame();
-    QSharedPointer<Frame> outPtr(new Frame);
+    auto outPtr = framePool.acquire();
     auto *hw_frame = outPtr->avFrame();
     auto err = av_hwframe_get_buffer(avctx->hw_frames_ctx, hw_frame, 0);
     if (err < 0) {
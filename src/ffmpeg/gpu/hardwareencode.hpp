@@ -1,6 +1,8 @@
 #ifndef HARDWAREENCODE_HPP
 #define HARDWAREENCODE_HPP
 
+#include <ffmpeg/frame.hpp>
+
 #include <QObject>
 
 extern "C" {
@@ -11,7 +13,6 @@ struct AVCodec;
 
 namespace Ffmpeg {
 
-class Frame;
 class CodecContext;
 class HardWareEncode : public QObject
 {
@@ -21,8 +22,9 @@ public:
 
     auto initEncoder(const AVCodec *encoder) -> bool;
     auto initHardWareDevice(CodecContext *codecContext) -> bool;
-    auto transToGpu(CodecContext *codecContext, QSharedPointer<Frame> inPtr, bool &ok)
-        -> QSharedPointer<Frame>;
+    // the gpu frame is taken from framePool
+    auto transToGpu(CodecContext *codecContext, FramePtr inPtr, FramePool &framePool, bool &ok)
+        -> FramePtr;
 
     [[nodiscard]] auto swFormat() const -> AVPixelFormat;
 
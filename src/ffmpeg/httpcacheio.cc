@@ -0,0 +1,374 @@
+#include "httpcacheio.hpp"
+#include "averrormanager.hpp"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+extern "C" {
+#include <libavformat/avio.h>
+#include <libavutil/error.h>
+#include <libavutil/mem.h>
+}
+
+namespace Ffmpeg {
+
+static constexpr quint32 s_rangesMagic = 0x51485243; // QHRC
+static constexpr quint32 s_rangesVersion = 1;
+static constexpr auto s_ioBufferSize = 64 * 1024;
+
+static std::atomic<qint64> s_cacheBudget = 1024LL * 1024 * 1024;
+
+static auto cacheDirectory() -> QString
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/http";
+}
+
+// an entry is used by one instance at a time, a second open of the url reads uncached
+static QMutex s_openKeysMutex;
+static QSet<QString> s_openKeys;
+
+// Removes the least recently used entries until the others and reserved bytes fit the budget.
+// Entries are counted by their full length, the sparse files take at most that on disk.
+static void evict(const QString &keepKey, qint64 reserved)
+{
+    QDir dir(cacheDirectory());
+    auto fileInfos = dir.entryInfoList({"*.data"}, QDir::Files);
+    auto lastUsed = [&dir](const QFileInfo &fileInfo) {
+        QFileInfo rangesInfo(dir.filePath(fileInfo.completeBaseName() + ".ranges"));
+        return rangesInfo.exists() ? qMax(rangesInfo.lastModified(), fileInfo.lastModified())
+                                   : fileInfo.lastModified();
+    };
+    std::sort(fileInfos.begin(),
+              fileInfos.end(),
+              [&lastUsed](const QFileInfo &left, const QFileInfo &right) {
+                  return lastUsed(left) > lastUsed(right);
+              });
+
+    auto total = reserved;
+    QMutexLocker locker(&s_openKeysMutex);
+    for (const auto &fileInfo : std::as_const(fileInfos)) {
+        auto key = fileInfo.completeBaseName();
+        if (key == keepKey) {
+            continue;
+        }
+        total += fileInfo.size();
+        if (total <= s_cacheBudget.load() || s_openKeys.contains(key)) {
+            continue;
+        }
+        total -= fileInfo.size();
+        dir.remove(fileInfo.fileName());
+        dir.remove(key + ".ranges");
+    }
+}
+
+class HttpCacheIO::HttpCacheIOPrivate
+{
+public:
+    explicit HttpCacheIOPrivate(HttpCacheIO *q)
+        : q_ptr(q)
+    {}
+
+    static auto readPacket(void *opaque, uint8_t *buf, int bufSize) -> int
+    {
+        return static_cast<HttpCacheIOPrivate *>(opaque)->read(buf, bufSize);
+    }
+
+    static auto seekPacket(void *opaque, int64_t offset, int whence) -> int64_t
+    {
+        return static_cast<HttpCacheIOPrivate *>(opaque)->seek(offset, whence);
+    }
+
+    // end of the fetched range holding position, -1 if it is not fetched
+    [[nodiscard]] auto cachedEnd(qint64 position) const -> qint64
+    {
+        auto iter = ranges.upperBound(position);
+        if (iter == ranges.cbegin()) {
+            return -1;
+        }
+        --iter;
+        return iter.value() > position ? iter.value() : -1;
+    }
+
+    [[nodiscard]] auto nextCachedStart(qint64 position) const -> qint64
+    {
+        auto iter = ranges.upperBound(position);
+        return iter == ranges.cend() ? length : iter.key();
+    }
+
+    void addRange(qint64 start, qint64 end)
+    {
+        auto iter = ranges.upperBound(start);
+        if (iter != ranges.begin() && std::prev(iter).value() >= start) {
+            --iter;
+            start = iter.key();
+            end = qMax(end, iter.value());
+            cachedBytes -= iter.value() - iter.key();
+            iter = ranges.erase(iter);
+        }
+        while (iter != ranges.end() && iter.key() <= end) {
+            end = qMax(end, iter.value());
+            cachedBytes -= iter.value() - iter.key();
+            iter = ranges.erase(iter);
+        }
+        ranges.insert(start, end);
+        cachedBytes += end - start;
+    }
+
+    auto read(uint8_t *buf, int bufSize) -> int
+    {
+        if (pos >= length) {
+            return AVERROR_EOF;
+        }
+        auto end = cachedEnd(pos);
+        if (end > pos) {
+            auto size = qMin<qint64>(bufSize, end - pos);
+            if (!dataFile.seek(pos)) {
+                return AVERROR(EIO);
+            }
+            auto ret = dataFile.read(reinterpret_cast<char *>(buf), size);
+            if (ret <= 0) {
+                return AVERROR(EIO);
+            }
+            pos += ret;
+            return static_cast<int>(ret);
+        }
+
+        auto size = static_cast<int>(qMin<qint64>(bufSize, nextCachedStart(pos) - pos));
+        if (innerPos != pos) {
+            auto ret = avio_seek(innerContext, pos, SEEK_SET);
+            if (ret < 0) {
+                innerPos = -1;
+                SET_ERROR_CODE(static_cast<int>(ret));
+                return static_cast<int>(ret);
+            }
+            innerPos = pos;
+        }
+        auto ret = avio_read_partial(innerContext, buf, size);
+        if (ret <= 0) {
+            innerPos = -1;
+            if (ret < 0 && ret != AVERROR_EOF) {
+                SET_ERROR_CODE(ret);
+            }
+            return ret == 0 ? AVERROR_EOF : ret;
+        }
+        innerPos += ret;
+        if (dataFile.seek(pos) && dataFile.write(reinterpret_cast<char *>(buf), ret) == ret) {
+            addRange(pos, pos + ret);
+        }
+        pos += ret;
+        return ret;
+    }
+
+    auto seek(int64_t offset, int whence) -> int64_t
+    {
+        switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE: return length;
+        case SEEK_SET: break;
+        case SEEK_CUR: offset += pos; break;
+        case SEEK_END: offset += length; break;
+        default: return AVERROR(EINVAL);
+        }
+        if (offset < 0) {
+            return AVERROR(EINVAL);
+        }
+        // the network is only asked on the next read outside the fetched ranges
+        pos = offset;
+        return pos;
+    }
+
+    auto loadRanges() -> bool
+    {
+        QFile file(rangesPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        QDataStream stream(&file);
+        quint32 magic = 0;
+        quint32 version = 0;
+        qint64 storedLength = 0;
+        QByteArray storedUrl;
+        quint32 count = 0;
+        stream >> magic >> version >> storedLength >> storedUrl >> count;
+        if (magic != s_rangesMagic || version != s_rangesVersion || storedLength != length
+            || storedUrl != url) {
+            return false;
+        }
+        for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+            qint64 start = 0;
+            qint64 end = 0;
+            stream >> start >> end;
+            if (start >= 0 && start < end && end <= length) {
+                addRange(start, end);
+            }
+        }
+        if (stream.status() != QDataStream::Ok) {
+            qWarning() << "Http cache ranges corrupt:" << rangesPath;
+            ranges.clear();
+            cachedBytes = 0;
+            return false;
+        }
+        return true;
+    }
+
+    auto saveRanges() const -> bool
+    {
+        QSaveFile file(rangesPath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << file.errorString();
+            return false;
+        }
+        QDataStream stream(&file);
+        stream << s_rangesMagic << s_rangesVersion << length << url
+               << static_cast<quint32>(ranges.size());
+        for (auto iter = ranges.cbegin(); iter != ranges.cend(); ++iter) {
+            stream << iter.key() << iter.value();
+        }
+        return file.commit();
+    }
+
+    HttpCacheIO *q_ptr;
+
+    QByteArray url;
+    QString key;
+    QString rangesPath;
+    QFile dataFile;
+    qint64 length = 0;
+    qint64 pos = 0;
+    // offset of innerContext, -1 after a failure, it is seeked on the next fetch
+    qint64 innerPos = 0;
+    // fetched [start, end) ranges, disjoint and apart
+    QMap<qint64, qint64> ranges;
+    qint64 cachedBytes = 0;
+
+    AVIOContext *innerContext = nullptr;
+    AVIOContext *avioContext = nullptr;
+};
+
+void HttpCacheIO::setCacheBudget(qint64 bytes)
+{
+    s_cacheBudget.store(qMax(bytes, qint64(0)));
+    evict({}, 0);
+}
+
+auto HttpCacheIO::cacheBudget() -> qint64
+{
+    return s_cacheBudget.load();
+}
+
+auto HttpCacheIO::isCacheable(const QString &url) -> bool
+{
+    auto scheme = QUrl(url).scheme();
+    return scheme == "http" || scheme == "https";
+}
+
+HttpCacheIO::HttpCacheIO()
+    : d_ptr(new HttpCacheIOPrivate(this))
+{}
+
+HttpCacheIO::~HttpCacheIO()
+{
+    close();
+}
+
+auto HttpCacheIO::open(const QByteArray &url) -> bool
+{
+    close();
+    if (s_cacheBudget.load() <= 0) {
+        return false;
+    }
+    auto ret = avio_open2(&d_ptr->innerContext, url.constData(), AVIO_FLAG_READ, nullptr, nullptr);
+    if (ret < 0) {
+        SET_ERROR_CODE(ret);
+        return false;
+    }
+    // live streams and servers without range requests cannot be cached piecewise
+    d_ptr->length = avio_size(d_ptr->innerContext);
+    if (d_ptr->length <= 0 || d_ptr->length > s_cacheBudget.load()
+        || (d_ptr->innerContext->seekable & AVIO_SEEKABLE_NORMAL) == 0) {
+        avio_closep(&d_ptr->innerContext);
+        return false;
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(url);
+    hash.addData(QByteArray::number(d_ptr->length));
+    auto key = QString::fromLatin1(hash.result().toHex());
+    {
+        QMutexLocker locker(&s_openKeysMutex);
+        if (s_openKeys.contains(key)) {
+            avio_closep(&d_ptr->innerContext);
+            return false;
+        }
+        s_openKeys.insert(key);
+    }
+    d_ptr->url = url;
+    d_ptr->key = key;
+    d_ptr->pos = d_ptr->innerPos = 0;
+
+    QDir dir(cacheDirectory());
+    dir.mkpath(".");
+    evict(key, d_ptr->length);
+    d_ptr->rangesPath = dir.filePath(key + ".ranges");
+    d_ptr->dataFile.setFileName(dir.filePath(key + ".data"));
+    if (d_ptr->dataFile.size() == d_ptr->length) {
+        d_ptr->loadRanges();
+    }
+    // resizing leaves a sparse file, only fetched ranges take disk space
+    if (!d_ptr->dataFile.open(QIODevice::ReadWrite)
+        || (d_ptr->dataFile.size() != d_ptr->length && !d_ptr->dataFile.resize(d_ptr->length))) {
+        qWarning() << d_ptr->dataFile.errorString();
+        close();
+        return false;
+    }
+
+    auto *buffer = static_cast<uint8_t *>(av_malloc(s_ioBufferSize));
+    d_ptr->avioContext = avio_alloc_context(buffer,
+                                            s_ioBufferSize,
+                                            0,
+                                            d_ptr.data(),
+                                            &HttpCacheIOPrivate::readPacket,
+                                            nullptr,
+                                            &HttpCacheIOPrivate::seekPacket);
+    d_ptr->avioContext->seekable = AVIO_SEEKABLE_NORMAL;
+    return true;
+}
+
+void HttpCacheIO::close()
+{
+    if (d_ptr->avioContext != nullptr) {
+        av_freep(&d_ptr->avioContext->buffer);
+        avio_context_free(&d_ptr->avioContext);
+    }
+    if (d_ptr->innerContext != nullptr) {
+        avio_closep(&d_ptr->innerContext);
+    }
+    if (d_ptr->dataFile.isOpen()) {
+        d_ptr->dataFile.close();
+        d_ptr->saveRanges();
+    }
+    if (!d_ptr->key.isEmpty()) {
+        QMutexLocker locker(&s_openKeysMutex);
+        s_openKeys.remove(d_ptr->key);
+    }
+    d_ptr->key.clear();
+    d_ptr->url.clear();
+    d_ptr->ranges.clear();
+    d_ptr->cachedBytes = 0;
+    d_ptr->length = 0;
+}
+
+auto HttpCacheIO::avioContext() -> AVIOContext *
+{
+    return d_ptr->avioContext;
+}
+
+auto HttpCacheIO::cachedBytes() const -> qint64
+{
+    return d_ptr->cachedBytes;
+}
+
+} // namespace Ffmpeg
@@ -0,0 +1,47 @@
+#ifndef HTTPCACHEIO_HPP
+#define HTTPCACHEIO_HPP
+
+#include "ffmepg_global.h"
+
+#include <QtCore>
+
+struct AVIOContext;
+
+namespace Ffmpeg {
+
+// Custom AVIOContext keeping what is downloaded from an http(s) url in a sparse file of the
+// cache location, keyed by url and content length, with the fetched byte ranges next to it.
+// Reads of fetched ranges never go to the network, the rest is fetched with range requests
+// and written to the cache. Least recently used entries are evicted over the budget. Entries
+// are not revalidated, so it is only used when asked for through FormatContext::setHttpCache.
+class FFMPEG_EXPORT HttpCacheIO
+{
+    Q_DISABLE_COPY_MOVE(HttpCacheIO)
+public:
+    // bytes on disk for all entries, 0 disables the cache, 1 GiB by default
+    static void setCacheBudget(qint64 bytes);
+    static auto cacheBudget() -> qint64;
+    static auto isCacheable(const QString &url) -> bool;
+
+    HttpCacheIO();
+    ~HttpCacheIO();
+
+    // false if the resource has no length, no range support or its entry is in use elsewhere,
+    // read it the usual way then
+    auto open(const QByteArray &url) -> bool;
+    void close();
+
+    // for AVFormatContext::pb with AVFMT_FLAG_CUSTOM_IO, owned by this
+    auto avioContext() -> AVIOContext *;
+
+    // bytes of the resource in the cache
+    [[nodiscard]] auto cachedBytes() const -> qint64;
+
+private:
+    class HttpCacheIOPrivate;
+    QScopedPointer<HttpCacheIOPrivate> d_ptr;
+};
+
+} // namespace Ffmpeg
+
+#endif // HTTPCACHEIO_HPP
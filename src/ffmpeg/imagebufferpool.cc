@@ -0,0 +1,129 @@
+#include "imagebufferpool.hpp"
+#include "averrormanager.hpp"
+#include "frame.hpp"
+
+#include <QMutex>
+
+#include <algorithm>
+#include <list>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+#include <libavutil/imgutils.h>
+}
+
+namespace Ffmpeg {
+
+class ImageBufferPool::ImageBufferPoolPrivate
+{
+public:
+    explicit ImageBufferPoolPrivate(ImageBufferPool *q)
+        : q_ptr(q)
+    {}
+
+    ~ImageBufferPoolPrivate()
+    {
+        for (auto &entry : entries) {
+            av_buffer_pool_uninit(&entry.pool);
+        }
+    }
+
+    struct Entry
+    {
+        QSize size;
+        AVPixelFormat pix_fmt = AV_PIX_FMT_NONE;
+        int align = 1;
+        AVBufferPool *pool = nullptr;
+    };
+
+    auto getBuffer(const QSize &size, AVPixelFormat pix_fmt, int align, int bufferSize)
+        -> AVBufferRef *
+    {
+        QMutexLocker locker(&mutex);
+        auto iter = std::find_if(entries.begin(), entries.end(), [&](const Entry &entry) {
+            return entry.size == size && entry.pix_fmt == pix_fmt && entry.align == align;
+        });
+        if (iter != entries.end()) {
+            // most recently used first
+            entries.splice(entries.begin(), entries, iter);
+        } else {
+            // av_image_alloc pads the buffer as well, sws_scale may write a little past the end
+            auto *pool = av_buffer_pool_init(bufferSize + AV_INPUT_BUFFER_PADDING_SIZE, nullptr);
+            if (pool == nullptr) {
+                return nullptr;
+            }
+            entries.push_front(Entry{size, pix_fmt, align, pool});
+            while (static_cast<int>(entries.size()) > maxPools) {
+                // buffers still in use keep the pool alive until they are released
+                av_buffer_pool_uninit(&entries.back().pool);
+                entries.pop_back();
+            }
+        }
+        return av_buffer_pool_get(entries.front().pool);
+    }
+
+    ImageBufferPool *q_ptr;
+
+    mutable QMutex mutex;
+    std::list<Entry> entries;
+    int maxPools = 4;
+};
+
+ImageBufferPool::ImageBufferPool(QObject *parent)
+    : QObject{parent}
+    , d_ptr(new ImageBufferPoolPrivate(this))
+{}
+
+ImageBufferPool::~ImageBufferPool() = default;
+
+auto ImageBufferPool::imageAlloc(Frame *frame, const QSize &size, AVPixelFormat pix_fmt, int align)
+    -> bool
+{
+    auto *avFrame = frame->avFrame();
+    Q_ASSERT(avFrame != nullptr);
+    Q_ASSERT(avFrame->buf[0] == nullptr);
+    Q_ASSERT(size.width() > 0);
+    Q_ASSERT(size.height() > 0);
+    Q_ASSERT(pix_fmt != AV_PIX_FMT_NONE);
+
+    auto bufferSize = av_image_get_buffer_size(pix_fmt, size.width(), size.height(), align);
+    if (bufferSize < 0) {
+        SET_ERROR_CODE(bufferSize);
+        return false;
+    }
+    auto *buf = d_ptr->getBuffer(size, pix_fmt, align, bufferSize);
+    if (buf == nullptr) {
+        SET_ERROR_CODE(AVERROR(ENOMEM));
+        return false;
+    }
+    auto ret = av_image_fill_arrays(avFrame->data,
+                                    avFrame->linesize,
+                                    buf->data,
+                                    pix_fmt,
+                                    size.width(),
+                                    size.height(),
+                                    align);
+    if (ret < 0) {
+        av_buffer_unref(&buf);
+        SET_ERROR_CODE(ret);
+        return false;
+    }
+    avFrame->buf[0] = buf;
+    return true;
+}
+
+void ImageBufferPool::setMaxPools(int maxPools)
+{
+    Q_ASSERT(maxPools > 0);
+    QMutexLocker locker(&d_ptr->mutex);
+    d_ptr->maxPools = maxPools;
+}
+
+auto ImageBufferPool::maxPools() const -> int
+{
+    QMutexLocker locker(&d_ptr->mutex);
+    return d_ptr->maxPools;
+}
+
+} // namespace Ffmpeg
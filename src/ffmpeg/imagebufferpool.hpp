@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ffmepg_global.h"
+
+#include <QObject>
+#include <QSize>
+
+extern "C" {
+#include <libavutil/pixfmt.h>
+}
+
+namespace Ffmpeg {
+
+class Frame;
+
+// Image buffers for converted frames, backed by one AVBufferPool per (size, pix_fmt, align).
+// The buffer is attached to the frame as buf[0], so it goes back to the pool when the frame is
+// unref'ed or destroyed, even after the ImageBufferPool itself is gone. Thread safe.
+class FFMPEG_EXPORT ImageBufferPool : public QObject
+{
+public:
+    explicit ImageBufferPool(QObject *parent = nullptr);
+    ~ImageBufferPool() override;
+
+    // Same layout as Frame::imageAlloc, frame must not hold any buffer
+    auto imageAlloc(Frame *frame, const QSize &size, AVPixelFormat pix_fmt, int align = 1)
+        -> bool;
+
+    // number of (size, pix_fmt, align) keys kept, the least recently used one is dropped
+    void setMaxPools(int maxPools);
+    [[nodiscard]] auto maxPools() const -> int;
+
+private:
+    class ImageBufferPoolPrivate;
+    QScopedPointer<ImageBufferPoolPrivate> d_ptr;
+};
+
+} // namespace Ffmpeg
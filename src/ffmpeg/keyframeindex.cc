@@ -0,0 +1,321 @@
+#include "keyframeindex.hpp"
+#include "formatcontext.h"
+#include "packet.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace Ffmpeg {
+
+static constexpr quint32 s_cacheMagic = 0x514B4958; // QKIX
+static constexpr quint32 s_cacheVersion = 1;
+// a demuxer index ending this close to the end of the stream counts as complete, an incomplete
+// index is trusted this far after a keyframe
+static constexpr qint64 s_coverageSlack = 10 * AV_TIME_BASE;
+
+static auto isIndexedStream(const AVStream *stream) -> bool
+{
+    return stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO
+           && (stream->disposition & AV_DISPOSITION_ATTACHED_PIC) == 0;
+}
+
+static auto toMicroseconds(const AVStream *stream, qint64 timestamp) -> qint64
+{
+    return av_rescale_q(timestamp, stream->time_base, AVRational{1, AV_TIME_BASE});
+}
+
+static auto cacheKey(const QFileInfo &fileInfo) -> QString
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(fileInfo.canonicalFilePath().toUtf8());
+    hash.addData(QByteArray::number(fileInfo.size()));
+    hash.addData(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    return hash.result().toHex();
+}
+
+class KeyframeIndexScanTask : public QRunnable
+{
+public:
+    explicit KeyframeIndexScanTask(const KeyframeIndexPtr &index)
+        : m_index(index)
+        , m_filepath(index->filePath())
+    {}
+
+    void run() override
+    {
+        FormatContext formatContext;
+        if (!formatContext.openFilePath(m_filepath) || !formatContext.findStream()) {
+            return;
+        }
+        auto videoIndex = formatContext.findBestStreamIndex(AVMEDIA_TYPE_VIDEO);
+        if (videoIndex < 0) {
+            return;
+        }
+        // record here, a strong reference held by the FormatContext would keep the index alive
+        formatContext.setKeyframeIndex({});
+        formatContext.discardStreamExcluded({videoIndex});
+        auto *stream = formatContext.stream(videoIndex);
+        Packet packet;
+        while (formatContext.readFrame(&packet)) {
+            auto index = m_index.toStrongRef();
+            if (index.isNull() || index->isComplete()) {
+                return;
+            }
+            index->record(stream, packet.avPacket());
+            packet.unref();
+        }
+        auto index = m_index.toStrongRef();
+        if (index.isNull() || index->size(stream->index) == 0) {
+            return;
+        }
+        index->setComplete();
+        index->save();
+    }
+
+private:
+    QWeakPointer<KeyframeIndex> m_index;
+    QString m_filepath;
+};
+
+class KeyframeIndex::KeyframeIndexPrivate
+{
+public:
+    explicit KeyframeIndexPrivate(KeyframeIndex *q)
+        : q_ptr(q)
+    {}
+
+    static void insert(std::vector<Entry> &entries, const Entry &entry)
+    {
+        if (entries.empty() || entries.back().pts < entry.pts) {
+            entries.push_back(entry);
+            return;
+        }
+        auto iter = std::lower_bound(entries.begin(),
+                                     entries.end(),
+                                     entry.pts,
+                                     [](const Entry &e, qint64 pts) { return e.pts < pts; });
+        if (iter != entries.end() && iter->pts == entry.pts) {
+            return;
+        }
+        entries.insert(iter, entry);
+    }
+
+    KeyframeIndex *q_ptr;
+
+    QString filepath;
+    QString key;
+    QString cacheFile;
+
+    mutable QMutex mutex;
+    QMap<int, std::vector<Entry>> streams;
+    std::atomic_bool complete = false;
+    std::atomic_bool scanStarted = false;
+};
+
+auto KeyframeIndex::forFile(const QString &filepath) -> QSharedPointer<KeyframeIndex>
+{
+    static QMutex mutex;
+    static QHash<QString, QWeakPointer<KeyframeIndex>> indexs;
+
+    QFileInfo fileInfo(filepath);
+    if (!fileInfo.isFile()) {
+        return {};
+    }
+    auto key = cacheKey(fileInfo);
+    QMutexLocker locker(&mutex);
+    auto indexPtr = indexs.value(key).toStrongRef();
+    if (indexPtr.isNull()) {
+        indexPtr.reset(new KeyframeIndex(fileInfo.canonicalFilePath()));
+        indexPtr->d_ptr->key = key;
+        indexPtr->d_ptr->cacheFile = QStandardPaths::writableLocation(
+                                         QStandardPaths::CacheLocation)
+                                     + "/keyframes/" + key + ".idx";
+        indexPtr->load();
+        indexs.insert(key, indexPtr);
+    }
+    return indexPtr;
+}
+
+KeyframeIndex::KeyframeIndex(const QString &filepath)
+    : d_ptr(new KeyframeIndexPrivate(this))
+{
+    d_ptr->filepath = filepath;
+}
+
+KeyframeIndex::~KeyframeIndex() = default;
+
+auto KeyframeIndex::filePath() const -> QString
+{
+    return d_ptr->filepath;
+}
+
+void KeyframeIndex::importStream(AVStream *stream)
+{
+    if (d_ptr->complete.load() || !isIndexedStream(stream)) {
+        return;
+    }
+    auto count = avformat_index_get_entries_count(stream);
+    QMutexLocker locker(&d_ptr->mutex);
+    auto &entries = d_ptr->streams[stream->index];
+    for (int i = 0; i < count; ++i) {
+        const auto *indexEntry = avformat_index_get_entry(stream, i);
+        if ((indexEntry->flags & AVINDEX_KEYFRAME) == 0 || indexEntry->pos < 0) {
+            continue;
+        }
+        KeyframeIndexPrivate::insert(entries,
+                                     {toMicroseconds(stream, indexEntry->timestamp),
+                                      indexEntry->pos,
+                                      indexEntry->size});
+    }
+    if (entries.size() < 2 || stream->duration == AV_NOPTS_VALUE) {
+        return;
+    }
+    auto end = toMicroseconds(stream,
+                              stream->duration
+                                  + (stream->start_time != AV_NOPTS_VALUE ? stream->start_time
+                                                                          : 0));
+    if (entries.back().pts >= end - s_coverageSlack) {
+        d_ptr->complete.store(true);
+    }
+}
+
+void KeyframeIndex::record(AVStream *stream, const AVPacket *packet)
+{
+    if (d_ptr->complete.load() || (packet->flags & AV_PKT_FLAG_KEY) == 0 || packet->pos < 0
+        || !isIndexedStream(stream)) {
+        return;
+    }
+    auto pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+    if (pts == AV_NOPTS_VALUE) {
+        return;
+    }
+    QMutexLocker locker(&d_ptr->mutex);
+    KeyframeIndexPrivate::insert(d_ptr->streams[stream->index],
+                                 {toMicroseconds(stream, pts), packet->pos, packet->size});
+}
+
+auto KeyframeIndex::find(int streamIndex, qint64 timestamp, Entry &entry) const -> bool
+{
+    QMutexLocker locker(&d_ptr->mutex);
+    auto iter = d_ptr->streams.constFind(streamIndex);
+    if (iter == d_ptr->streams.cend()) {
+        return false;
+    }
+    const auto &entries = iter.value();
+    auto next = std::upper_bound(entries.cbegin(),
+                                 entries.cend(),
+                                 timestamp,
+                                 [](qint64 pts, const Entry &e) { return pts < e.pts; });
+    if (next == entries.cbegin()) {
+        return false;
+    }
+    // an incomplete index may have a gap before timestamp, a keyframe that far back is still
+    // correct but the demuxer index likely knows a closer one
+    const auto &previous = *(next - 1);
+    if (!d_ptr->complete.load() && timestamp - previous.pts > s_coverageSlack) {
+        return false;
+    }
+    entry = previous;
+    return true;
+}
+
+auto KeyframeIndex::size(int streamIndex) const -> int
+{
+    QMutexLocker locker(&d_ptr->mutex);
+    return static_cast<int>(d_ptr->streams.value(streamIndex).size());
+}
+
+auto KeyframeIndex::isComplete() const -> bool
+{
+    return d_ptr->complete.load();
+}
+
+void KeyframeIndex::setComplete()
+{
+    d_ptr->complete.store(true);
+}
+
+void KeyframeIndex::scanInBackground()
+{
+    if (d_ptr->complete.load() || d_ptr->scanStarted.exchange(true)) {
+        return;
+    }
+    auto indexPtr = forFile(d_ptr->filepath);
+    if (indexPtr.data() != this) {
+        return;
+    }
+    QThreadPool::globalInstance()->start(new KeyframeIndexScanTask(indexPtr));
+}
+
+auto KeyframeIndex::save() const -> bool
+{
+    if (!d_ptr->complete.load() || d_ptr->cacheFile.isEmpty()) {
+        return false;
+    }
+    QDir().mkpath(QFileInfo(d_ptr->cacheFile).absolutePath());
+    QSaveFile file(d_ptr->cacheFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << file.errorString();
+        return false;
+    }
+    QDataStream stream(&file);
+    stream << s_cacheMagic << s_cacheVersion;
+    {
+        QMutexLocker locker(&d_ptr->mutex);
+        stream << static_cast<qint32>(d_ptr->streams.size());
+        for (auto iter = d_ptr->streams.cbegin(); iter != d_ptr->streams.cend(); ++iter) {
+            stream << static_cast<qint32>(iter.key()) << static_cast<quint32>(iter->size());
+            for (const auto &entry : iter.value()) {
+                stream << entry.pts << entry.pos << static_cast<qint32>(entry.size);
+            }
+        }
+    }
+    return file.commit();
+}
+
+auto KeyframeIndex::load() -> bool
+{
+    QFile file(d_ptr->cacheFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 streamCount = 0;
+    stream >> magic >> version >> streamCount;
+    if (magic != s_cacheMagic || version != s_cacheVersion || streamCount < 0) {
+        return false;
+    }
+    QMap<int, std::vector<Entry>> streams;
+    for (qint32 i = 0; i < streamCount; ++i) {
+        qint32 streamIndex = 0;
+        quint32 count = 0;
+        stream >> streamIndex >> count;
+        auto &entries = streams[streamIndex];
+        entries.reserve(qMin<quint32>(count, file.size() / 20));
+        for (quint32 j = 0; j < count && stream.status() == QDataStream::Ok; ++j) {
+            Entry entry;
+            qint32 size = 0;
+            stream >> entry.pts >> entry.pos >> size;
+            entry.size = size;
+            entries.push_back(entry);
+        }
+    }
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "Keyframe index cache corrupt:" << d_ptr->cacheFile;
+        return false;
+    }
+    QMutexLocker locker(&d_ptr->mutex);
+    d_ptr->streams = std::move(streams);
+    d_ptr->complete.store(true);
+    return true;
+}
+
+} // namespace Ffmpeg
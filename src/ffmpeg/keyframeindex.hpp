@@ -0,0 +1,69 @@
+#ifndef KEYFRAMEINDEX_HPP
+#define KEYFRAMEINDEX_HPP
+
+#include "ffmepg_global.h"
+
+#include <QtCore>
+
+struct AVFormatContext;
+struct AVPacket;
+struct AVStream;
+
+namespace Ffmpeg {
+
+// Keyframes of one local media file, per stream sorted by pts.
+// Filled from the demuxer index when the container has one, otherwise from the packets read while
+// playing and from a background scan. A complete index is kept in the cache location, keyed by
+// path, size and modification time, so later opens of the file skip the scan. Thread safe.
+class FFMPEG_EXPORT KeyframeIndex
+{
+    Q_DISABLE_COPY_MOVE(KeyframeIndex)
+public:
+    struct Entry
+    {
+        qint64 pts = 0; // microseconds, AV_TIME_BASE based like FormatContext::seek
+        qint64 pos = -1; // byte offset of the packet in the file
+        int size = 0;
+    };
+
+    // one instance per file in the process, loaded from the cache on first use,
+    // nullptr if the file is not local
+    static auto forFile(const QString &filepath) -> QSharedPointer<KeyframeIndex>;
+
+    ~KeyframeIndex();
+
+    [[nodiscard]] auto filePath() const -> QString;
+
+    // takes the keyframes the demuxer already knows, completes the index if it had any
+    void importStream(AVStream *stream);
+    // records packet if it is a keyframe of a video stream
+    void record(AVStream *stream, const AVPacket *packet);
+
+    // the last keyframe at or before timestamp, false if the index does not cover timestamp
+    [[nodiscard]] auto find(int streamIndex, qint64 timestamp, Entry &entry) const -> bool;
+    [[nodiscard]] auto size(int streamIndex) const -> int;
+
+    [[nodiscard]] auto isComplete() const -> bool;
+    // every packet of the file was recorded, lookups at the end of the index are trusted
+    void setComplete();
+
+    // reads every packet of the best video stream on the global thread pool, once,
+    // saves the index when done
+    void scanInBackground();
+
+    auto save() const -> bool;
+
+private:
+    explicit KeyframeIndex(const QString &filepath);
+
+    auto load() -> bool;
+
+    class KeyframeIndexPrivate;
+    QScopedPointer<KeyframeIndexPrivate> d_ptr;
+};
+
+using KeyframeIndexPtr = QSharedPointer<KeyframeIndex>;
+
+} // namespace Ffmpeg
+
+#endif // KEYFRAMEINDEX_HPP
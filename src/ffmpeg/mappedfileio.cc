@@ -0,0 +1,189 @@
+#include "mappedfileio.hpp"
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+extern "C" {
+#include <libavformat/avio.h>
+#include <libavutil/error.h>
+#include <libavutil/mem.h>
+}
+
+namespace Ffmpeg {
+
+static constexpr auto s_ioBufferSize = 64 * 1024;
+// pages ahead of the read position asked for, again once half of them were read
+static constexpr qint64 s_willNeedSize = 16 * 1024 * 1024;
+
+class MappedFileIO::MappedFileIOPrivate
+{
+public:
+    explicit MappedFileIOPrivate(MappedFileIO *q)
+        : q_ptr(q)
+    {}
+
+    static auto readPacket(void *opaque, uint8_t *buf, int bufSize) -> int
+    {
+        return static_cast<MappedFileIOPrivate *>(opaque)->read(buf, bufSize);
+    }
+
+    static auto seekPacket(void *opaque, int64_t offset, int whence) -> int64_t
+    {
+        return static_cast<MappedFileIOPrivate *>(opaque)->seek(offset, whence);
+    }
+
+    auto read(uint8_t *buf, int bufSize) -> int
+    {
+        if (pos >= size && !remap()) {
+            return AVERROR_EOF;
+        }
+        auto len = static_cast<int>(qMin<qint64>(bufSize, size - pos));
+        memcpy(buf, data + pos, len);
+        pos += len;
+        if (pos > advisedEnd - s_willNeedSize / 2) {
+            adviseWillNeed();
+        }
+        return len;
+    }
+
+    auto seek(int64_t offset, int whence) -> int64_t
+    {
+        switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE: remap(); return size;
+        case SEEK_SET: break;
+        case SEEK_CUR: offset += pos; break;
+        case SEEK_END: offset += size; break;
+        default: return AVERROR(EINVAL);
+        }
+        if (offset < 0) {
+            return AVERROR(EINVAL);
+        }
+        pos = offset;
+        if (pos < advisedEnd - s_willNeedSize || pos > advisedEnd - s_willNeedSize / 2) {
+            adviseWillNeed();
+        }
+        return pos;
+    }
+
+    // the file grew since it was mapped, a recording still being written
+    auto remap() -> bool
+    {
+        auto newSize = file.size();
+        if (newSize <= size) {
+            return false;
+        }
+        auto *newData = file.map(0, newSize);
+        if (newData == nullptr) {
+            return false;
+        }
+        file.unmap(data);
+        data = newData;
+        size = newSize;
+#ifdef Q_OS_UNIX
+        advise(POSIX_MADV_SEQUENTIAL, 0, size);
+#endif
+        adviseWillNeed();
+        return true;
+    }
+
+    void advise(int advice, qint64 offset, qint64 length)
+    {
+#ifdef Q_OS_UNIX
+        static const qint64 pageSize = sysconf(_SC_PAGESIZE);
+        auto begin = offset & ~(pageSize - 1);
+        auto end = qMin(offset + length, size);
+        if (end > begin) {
+            posix_madvise(data + begin, end - begin, advice);
+        }
+#else
+        Q_UNUSED(advice)
+        Q_UNUSED(offset)
+        Q_UNUSED(length)
+#endif
+    }
+
+    void adviseWillNeed()
+    {
+        if (pos >= size) {
+            return;
+        }
+#ifdef Q_OS_UNIX
+        advise(POSIX_MADV_WILLNEED, pos, s_willNeedSize);
+#endif
+        advisedEnd = pos + s_willNeedSize;
+    }
+
+    MappedFileIO *q_ptr;
+
+    QFile file;
+    uchar *data = nullptr;
+    qint64 size = 0;
+    qint64 pos = 0;
+    // end of the range last requested with WILLNEED
+    qint64 advisedEnd = 0;
+    AVIOContext *avioContext = nullptr;
+};
+
+MappedFileIO::MappedFileIO()
+    : d_ptr(new MappedFileIOPrivate(this))
+{}
+
+MappedFileIO::~MappedFileIO()
+{
+    close();
+}
+
+auto MappedFileIO::open(const QString &filepath) -> bool
+{
+    close();
+    d_ptr->file.setFileName(filepath);
+    if (!d_ptr->file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    d_ptr->size = d_ptr->file.size();
+    // empty files, pipes and files over the address space do not map
+    d_ptr->data = d_ptr->size > 0 ? d_ptr->file.map(0, d_ptr->size) : nullptr;
+    if (d_ptr->data == nullptr) {
+        qWarning() << "Failed to map" << filepath << d_ptr->file.errorString();
+        d_ptr->file.close();
+        return false;
+    }
+    d_ptr->pos = 0;
+#ifdef Q_OS_UNIX
+    d_ptr->advise(POSIX_MADV_SEQUENTIAL, 0, d_ptr->size);
+#endif
+    d_ptr->adviseWillNeed();
+
+    auto *buffer = static_cast<uint8_t *>(av_malloc(s_ioBufferSize));
+    d_ptr->avioContext = avio_alloc_context(buffer,
+                                            s_ioBufferSize,
+                                            0,
+                                            d_ptr.data(),
+                                            &MappedFileIOPrivate::readPacket,
+                                            nullptr,
+                                            &MappedFileIOPrivate::seekPacket);
+    return true;
+}
+
+void MappedFileIO::close()
+{
+    if (d_ptr->avioContext != nullptr) {
+        av_freep(&d_ptr->avioContext->buffer);
+        avio_context_free(&d_ptr->avioContext);
+    }
+    if (d_ptr->data != nullptr) {
+        d_ptr->file.unmap(d_ptr->data);
+        d_ptr->data = nullptr;
+    }
+    d_ptr->file.close();
+    d_ptr->size = d_ptr->pos = d_ptr->advisedEnd = 0;
+}
+
+auto MappedFileIO::avioContext() -> AVIOContext *
+{
+    return d_ptr->avioContext;
+}
+
+} // namespace Ffmpeg
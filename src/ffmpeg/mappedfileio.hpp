@@ -0,0 +1,37 @@
+#ifndef MAPPEDFILEIO_HPP
+#define MAPPEDFILEIO_HPP
+
+#include <QtCore>
+
+struct AVIOContext;
+
+namespace Ffmpeg {
+
+// Custom AVIOContext reading a local file through a memory mapping instead of read() calls.
+// The kernel is told the access is sequential and the pages ahead of the read position are
+// requested as it moves, seeks included.
+// A file still being written is mapped again at its new size when the reader reaches the end.
+// A file truncated while mapped raises SIGBUS on access, which read() would have reported as
+// the end of file, so the mapping is opt-in, see FormatContext::setMemoryMapping.
+class MappedFileIO
+{
+    Q_DISABLE_COPY_MOVE(MappedFileIO)
+public:
+    MappedFileIO();
+    ~MappedFileIO();
+
+    // false if the file cannot be mapped, read it the usual way then
+    auto open(const QString &filepath) -> bool;
+    void close();
+
+    // for AVFormatContext::pb with AVFMT_FLAG_CUSTOM_IO, owned by this
+    auto avioContext() -> AVIOContext *;
+
+private:
+    class MappedFileIOPrivate;
+    QScopedPointer<MappedFileIOPrivate> d_ptr;
+};
+
+} // namespace Ffmpeg
+
+#endif // MAPPEDFILEIO_HPP
@@ -16,7 +16,8 @@ struct AVChapter;
 
 namespace Ffmpeg {
 
-enum MediaState { Stopped, Opening, Playing, Pausing };
+// Buffering: playing, but waiting for the network before the queues run dry
+enum MediaState { Stopped, Opening, Playing, Pausing, Buffering };
 
 struct FFMPEG_EXPORT StreamInfo
 {
@@ -8,53 +8,39 @@ extern "C" {
 
 namespace Ffmpeg {
 
-class Packet::PacketPrivate
-{
-public:
-    explicit PacketPrivate(Packet *q)
-        : q_ptr(q)
-    {}
-    ~PacketPrivate() { av_packet_free(&packet); }
-
-    Packet *q_ptr;
-    AVPacket *packet = nullptr;
-};
-
 Packet::Packet()
-    : d_ptr(new PacketPrivate(this))
+    : m_packet(av_packet_alloc())
 {
-    d_ptr->packet = av_packet_alloc();
-
-    if (d_ptr->packet == nullptr) {
+    if (m_packet == nullptr) {
         qWarning() << "Could not allocate packet";
     }
 }
 
 Packet::Packet(const Packet &other)
-    : d_ptr(new PacketPrivate(this))
+    : Utils::RefCounted<Packet>(other)
+    , m_packet(av_packet_clone(other.m_packet))
 {
-    d_ptr->packet = av_packet_clone(other.d_ptr->packet);
-
-    if (d_ptr->packet == nullptr) {
+    if (m_packet == nullptr) {
         qWarning() << "Could not clone packet";
     }
 }
 
 Packet::Packet(Packet &&other) noexcept
-    : d_ptr(new PacketPrivate(this))
+    : m_packet(std::exchange(other.m_packet, nullptr))
+{}
+
+Packet::~Packet()
 {
-    d_ptr->packet = other.d_ptr->packet;
-    other.d_ptr->packet = nullptr;
+    av_packet_free(&m_packet);
 }
 
-Packet::~Packet() = default;
-
 auto Packet::operator=(const Packet &other) -> Packet &
 {
     if (this != &other) {
-        d_ptr->packet = av_packet_clone(other.d_ptr->packet);
+        av_packet_free(&m_packet);
+        m_packet = av_packet_clone(other.m_packet);
 
-        if (d_ptr->packet == nullptr) {
+        if (m_packet == nullptr) {
             qWarning() << "Could not clone packet";
         }
     }
@@ -65,8 +51,8 @@ auto Packet::operator=(const Packet &other) -> Packet &
 auto Packet::operator=(Packet &&other) noexcept -> Packet &
 {
     if (this != &other) {
-        d_ptr->packet = other.d_ptr->packet;
-        other.d_ptr->packet = nullptr;
+        av_packet_free(&m_packet);
+        m_packet = std::exchange(other.m_packet, nullptr);
     }
 
     return *this;
@@ -74,70 +60,76 @@ auto Packet::operator=(Packet &&other) noexcept -> Packet &
 
 auto Packet::isValid() -> bool
 {
-    if (nullptr == d_ptr->packet) {
+    if (nullptr == m_packet) {
         return false;
     }
-    return d_ptr->packet->size > 0;
+    return m_packet->size > 0;
 }
 
 auto Packet::isKey() -> bool
 {
-    Q_ASSERT(nullptr != d_ptr->packet);
-    return (d_ptr->packet->flags & AV_PKT_FLAG_KEY) != 0;
+    Q_ASSERT(nullptr != m_packet);
+    return (m_packet->flags & AV_PKT_FLAG_KEY) != 0;
 }
 
 void Packet::unref()
 {
-    Q_ASSERT(nullptr != d_ptr->packet);
-    av_packet_unref(d_ptr->packet);
+    Q_ASSERT(nullptr != m_packet);
+    av_packet_unref(m_packet);
 }
 
 void Packet::setPts(qint64 pts)
 {
-    Q_ASSERT(nullptr != d_ptr->packet);
-    d_ptr->packet->pts = pts;
+    Q_ASSERT(nullptr != m_packet);
+    m_packet->pts = pts;
 }
 
 auto Packet::pts() -> qint64
 {
-    Q_ASSERT(nullptr != d_ptr->packet);
-    return d_ptr->packet->pts;
+    Q_ASSERT(nullptr != m_packet);
+    return m_packet->pts;
 }
 
 void Packet::setDuration(qint64 duration)
 {
-    Q_ASSERT(nullptr != d_ptr->packet);
-    d_ptr->packet->duration = duration;
+    Q_ASSERT(nullptr != m_packet);
+    m_packet->duration = duration;
 }
 
 auto Packet::duration() -> qint64
 {
-    Q_ASSERT(nullptr != d_ptr->packet);
-    return d_ptr->packet->duration;
+    Q_ASSERT(nullptr != m_packet);
+    return m_packet->duration;
+}
+
+auto Packet::size() const -> int
+{
+    Q_ASSERT(nullptr != m_packet);
+    return m_packet->size;
 }
 
 void Packet::setStreamIndex(int index)
 {
-    Q_ASSERT(nullptr != d_ptr->packet);
-    d_ptr->packet->stream_index = index;
+    Q_ASSERT(nullptr != m_packet);
+    m_packet->stream_index = index;
 }
 
 auto Packet::streamIndex() const -> int
 {
-    Q_ASSERT(nullptr != d_ptr->packet);
-    return d_ptr->packet->stream_index;
+    Q_ASSERT(nullptr != m_packet);
+    return m_packet->stream_index;
 }
 
 void Packet::rescaleTs(const AVRational &srcTimeBase, const AVRational &dstTimeBase)
 {
-    Q_ASSERT(nullptr != d_ptr->packet);
-    av_packet_rescale_ts(d_ptr->packet, srcTimeBase, dstTimeBase);
+    Q_ASSERT(nullptr != m_packet);
+    av_packet_rescale_ts(m_packet, srcTimeBase, dstTimeBase);
 }
 
 auto Packet::avPacket() -> AVPacket *
 {
-    Q_ASSERT(nullptr != d_ptr->packet);
-    return d_ptr->packet;
+    Q_ASSERT(nullptr != m_packet);
+    return m_packet;
 }
 
 } // namespace Ffmpeg
@@ -3,6 +3,9 @@
 
 #include "ffmepg_global.h"
 
+#include <utils/intrusiveref.hpp>
+#include <utils/objectpool.hpp>
+
 #include <QtCore>
 
 struct AVPacket;
@@ -10,7 +13,9 @@ struct AVRational;
 
 namespace Ffmpeg {
 
-class FFMPEG_EXPORT Packet
+// Holds the AVPacket directly and carries its own reference count, a PacketRef is a single
+// pointer
+class FFMPEG_EXPORT Packet : public Utils::RefCounted<Packet>
 {
 public:
     Packet();
@@ -33,6 +38,8 @@ public:
     void setDuration(qint64 duration); // microseconds
     auto duration() -> qint64;
 
+    [[nodiscard]] auto size() const -> int; // bytes
+
     void setStreamIndex(int index);
     [[nodiscard]] auto streamIndex() const -> int;
 
@@ -41,11 +48,21 @@ public:
     auto avPacket() -> AVPacket *;
 
 private:
-    class PacketPrivate;
-    QScopedPointer<PacketPrivate> d_ptr;
+    AVPacket *m_packet = nullptr;
 };
 
-using PacketPtr = QSharedPointer<Packet>;
+using PacketRef = Utils::IntrusiveRef<Packet>;
+using PacketPtr = PacketRef;
+
+// Packets handed out are empty, they are unref'ed and returned to the pool when the last
+// PacketRef drops, so the demux loop reuses the Packet and its AVPacket
+class PacketPool : public Utils::ObjectPool<Packet>
+{
+public:
+    explicit PacketPool(int maxCached = 256)
+        : Utils::ObjectPool<Packet>([](Packet *packet) { packet->unref(); }, maxCached)
+    {}
+};
 
 } // namespace Ffmpeg
 
@@ -0,0 +1,132 @@
+#include "packetcache.hpp"
+
+#include <deque>
+
+extern "C" {
+#include <libavcodec/packet.h>
+#include <libavutil/avutil.h>
+}
+
+namespace Ffmpeg {
+
+class PacketCache::PacketCachePrivate
+{
+public:
+    struct SeekPoint
+    {
+        qint64 pts; // microseconds
+        quint64 sequence;
+    };
+
+    explicit PacketCachePrivate(PacketCache *q)
+        : q_ptr(q)
+    {}
+
+    void evict()
+    {
+        while (bytes > maxBytes && !packetPtrs.empty()) {
+            bytes -= packetPtrs.front()->size();
+            packetPtrs.pop_front();
+            firstSequence++;
+        }
+        while (!seekPoints.empty() && seekPoints.front().sequence < firstSequence) {
+            seekPoints.pop_front();
+        }
+    }
+
+    PacketCache *q_ptr;
+
+    qint64 maxBytes = 64 * 1024 * 1024;
+    qint64 bytes = 0;
+    // sequence number of packetPtrs.front()
+    quint64 firstSequence = 0;
+    std::deque<PacketPtr> packetPtrs;
+    // increasing pts, seek points of one stream are in decode order
+    std::deque<SeekPoint> seekPoints;
+    qint64 lastPts = AV_NOPTS_VALUE;
+    // next packet to replay, packetPtrs.size() when the demuxer is next
+    size_t replayIndex = 0;
+};
+
+PacketCache::PacketCache()
+    : d_ptr(new PacketCachePrivate(this))
+{}
+
+PacketCache::~PacketCache() = default;
+
+void PacketCache::setMaxBytes(qint64 maxBytes)
+{
+    d_ptr->maxBytes = qMax(maxBytes, qint64(0));
+    clear();
+}
+
+auto PacketCache::maxBytes() const -> qint64
+{
+    return d_ptr->maxBytes;
+}
+
+void PacketCache::append(const PacketPtr &packetPtr, const AVRational &timeBase, bool seekPoint)
+{
+    if (d_ptr->maxBytes <= 0) {
+        return;
+    }
+    Q_ASSERT(d_ptr->replayIndex == d_ptr->packetPtrs.size());
+    auto *avPacket = packetPtr->avPacket();
+    auto pts = avPacket->pts != AV_NOPTS_VALUE ? avPacket->pts : avPacket->dts;
+    if (pts != AV_NOPTS_VALUE) {
+        pts = av_rescale_q(pts, timeBase, AVRational{1, AV_TIME_BASE});
+        d_ptr->lastPts = d_ptr->lastPts == AV_NOPTS_VALUE ? pts : qMax(d_ptr->lastPts, pts);
+        if (seekPoint && (d_ptr->seekPoints.empty() || d_ptr->seekPoints.back().pts < pts)) {
+            d_ptr->seekPoints.push_back({pts, d_ptr->firstSequence + d_ptr->packetPtrs.size()});
+        }
+    }
+    d_ptr->packetPtrs.push_back(packetPtr);
+    d_ptr->bytes += packetPtr->size();
+    d_ptr->evict();
+    d_ptr->replayIndex = d_ptr->packetPtrs.size();
+}
+
+auto PacketCache::seek(qint64 position) -> bool
+{
+    d_ptr->replayIndex = d_ptr->packetPtrs.size();
+    if (d_ptr->seekPoints.empty() || position > d_ptr->lastPts) {
+        return false;
+    }
+    auto next = std::upper_bound(d_ptr->seekPoints.cbegin(),
+                                 d_ptr->seekPoints.cend(),
+                                 position,
+                                 [](qint64 pts, const PacketCachePrivate::SeekPoint &seekPoint) {
+                                     return pts < seekPoint.pts;
+                                 });
+    if (next == d_ptr->seekPoints.cbegin()) {
+        return false;
+    }
+    d_ptr->replayIndex = (next - 1)->sequence - d_ptr->firstSequence;
+    return true;
+}
+
+auto PacketCache::takeReplay(PacketPtr &packetPtr) -> bool
+{
+    if (d_ptr->replayIndex >= d_ptr->packetPtrs.size()) {
+        return false;
+    }
+    packetPtr = d_ptr->packetPtrs[d_ptr->replayIndex++];
+    return true;
+}
+
+void PacketCache::clear()
+{
+    d_ptr->bytes = 0;
+    d_ptr->firstSequence += d_ptr->packetPtrs.size();
+    d_ptr->packetPtrs.clear();
+    d_ptr->seekPoints.clear();
+    d_ptr->lastPts = AV_NOPTS_VALUE;
+    d_ptr->replayIndex = 0;
+}
+
+auto PacketCache::bytes() const -> qint64
+{
+    return d_ptr->bytes;
+}
+
+} // namespace Ffmpeg
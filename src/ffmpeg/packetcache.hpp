@@ -0,0 +1,45 @@
+#ifndef PACKETCACHE_HPP
+#define PACKETCACHE_HPP
+
+#include "ffmepg_global.h"
+#include "packet.h"
+
+namespace Ffmpeg {
+
+// The packets the player read last, bounded by bytes, with the seek points among them.
+// A seek between the first cached seek point and the newest packet is replayed from memory
+// and the demuxer goes on where it is, so short seeks skip avformat_seek_file and the I/O
+// behind it. Player thread only.
+class FFMPEG_EXPORT PacketCache
+{
+    Q_DISABLE_COPY_MOVE(PacketCache)
+public:
+    PacketCache();
+    ~PacketCache();
+
+    // 0 disables the cache
+    void setMaxBytes(qint64 maxBytes);
+    [[nodiscard]] auto maxBytes() const -> qint64;
+
+    // timeBase is the one of the stream of packetPtr, decoding can start at a seek point
+    void append(const PacketPtr &packetPtr, const AVRational &timeBase, bool seekPoint);
+
+    // Queues the cached packets from the seek point at or before position, microseconds,
+    // false if position is not cached
+    auto seek(qint64 position) -> bool;
+    // the next queued packet, false if the demuxer is next
+    auto takeReplay(PacketPtr &packetPtr) -> bool;
+
+    // after the demuxer moved somewhere else
+    void clear();
+
+    [[nodiscard]] auto bytes() const -> qint64;
+
+private:
+    class PacketCachePrivate;
+    QScopedPointer<PacketCachePrivate> d_ptr;
+};
+
+} // namespace Ffmpeg
+
+#endif // PACKETCACHE_HPP
@@ -0,0 +1,210 @@
+#include "packetdispatcher.hpp"
+
+#include <algorithm>
+#include <deque>
+
+namespace Ffmpeg {
+
+// the master decoder is fed past the budget while it holds less than this
+static constexpr qint64 s_masterLowWater = AV_TIME_BASE / 2; // microseconds
+
+class PacketDispatcher::PacketDispatcherPrivate
+{
+public:
+    struct Intake
+    {
+        int streamIndex = -1;
+        AVRational timeBase{};
+        Decoder<PacketPtr> *decoder = nullptr;
+        std::deque<PacketPtr> packetPtrs;
+    };
+
+    explicit PacketDispatcherPrivate(PacketDispatcher *q)
+        : q_ptr(q)
+    {}
+
+    auto intake(int streamIndex) -> Intake *
+    {
+        for (auto &intake : intakes) {
+            if (intake.streamIndex == streamIndex) {
+                return &intake;
+            }
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] auto masterIntake() const -> const Intake *
+    {
+        for (const auto &intake : intakes) {
+            if (intake.streamIndex == masterStream) {
+                return &intake;
+            }
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] auto masterStarving() const -> bool
+    {
+        const auto *intake = masterIntake();
+        return intake != nullptr && intake->packetPtrs.empty()
+               && (intake->decoder->size() == 0 || intake->decoder->duration() < s_masterLowWater);
+    }
+
+    PacketDispatcher *q_ptr;
+
+    // a handful of streams, a vector beats a map
+    std::vector<Intake> intakes;
+    int masterStream = -1;
+    qint64 byteBudget = 16 * 1024 * 1024;
+    qint64 bytes = 0;
+
+    QMutex mutex;
+    QWaitCondition condition;
+    std::atomic<quint64> wakeCount = 0;
+    // set by wait() under the mutex, seq_cst against wakeCount so no wakeup is lost
+    std::atomic_bool waiting = false;
+};
+
+PacketDispatcher::PacketDispatcher()
+    : d_ptr(new PacketDispatcherPrivate(this))
+{}
+
+PacketDispatcher::~PacketDispatcher() = default;
+
+void PacketDispatcher::setByteBudget(qint64 bytes)
+{
+    d_ptr->byteBudget = qMax(bytes, qint64(0));
+}
+
+auto PacketDispatcher::byteBudget() const -> qint64
+{
+    return d_ptr->byteBudget;
+}
+
+void PacketDispatcher::addStream(AVContextInfo *contextInfo, Decoder<PacketPtr> *decoder)
+{
+    if (!contextInfo->isIndexVaild() || d_ptr->intake(contextInfo->index()) != nullptr) {
+        return;
+    }
+    PacketDispatcherPrivate::Intake intake;
+    intake.streamIndex = contextInfo->index();
+    intake.timeBase = contextInfo->timebase();
+    intake.decoder = decoder;
+    d_ptr->intakes.push_back(std::move(intake));
+}
+
+void PacketDispatcher::setMasterStream(int streamIndex)
+{
+    d_ptr->masterStream = streamIndex;
+}
+
+void PacketDispatcher::reset()
+{
+    d_ptr->intakes.clear();
+    d_ptr->masterStream = -1;
+    d_ptr->bytes = 0;
+}
+
+auto PacketDispatcher::append(const PacketPtr &packetPtr) -> bool
+{
+    auto *intake = d_ptr->intake(packetPtr->streamIndex());
+    if (intake == nullptr) {
+        return false;
+    }
+    // straight through while the decoder has room, keeps the intake out of the common path
+    if (intake->packetPtrs.empty()) {
+        auto packet = packetPtr;
+        if (intake->decoder->tryAppend(std::move(packet))) {
+            return true;
+        }
+    }
+    intake->packetPtrs.push_back(packetPtr);
+    d_ptr->bytes += packetPtr->size();
+    return true;
+}
+
+void PacketDispatcher::dispatch()
+{
+    for (auto &intake : d_ptr->intakes) {
+        while (!intake.packetPtrs.empty()) {
+            auto size = intake.packetPtrs.front()->size();
+            if (!intake.decoder->tryAppend(std::move(intake.packetPtrs.front()))) {
+                break;
+            }
+            intake.packetPtrs.pop_front();
+            d_ptr->bytes -= size;
+        }
+    }
+}
+
+void PacketDispatcher::clear()
+{
+    for (auto &intake : d_ptr->intakes) {
+        intake.packetPtrs.clear();
+    }
+    d_ptr->bytes = 0;
+}
+
+auto PacketDispatcher::canRead() const -> bool
+{
+    return d_ptr->bytes < d_ptr->byteBudget || d_ptr->masterStarving();
+}
+
+auto PacketDispatcher::isEmpty() const -> bool
+{
+    return std::all_of(d_ptr->intakes.cbegin(), d_ptr->intakes.cend(), [](const auto &intake) {
+        return intake.packetPtrs.empty();
+    });
+}
+
+auto PacketDispatcher::bytes() const -> qint64
+{
+    return d_ptr->bytes;
+}
+
+auto PacketDispatcher::bufferedDuration() const -> qint64
+{
+    const auto *intake = d_ptr->masterIntake();
+    if (intake == nullptr) {
+        return 0;
+    }
+    auto duration = intake->decoder->duration();
+    if (intake->packetPtrs.size() > 1) {
+        auto front = queueItemTimestamp(intake->packetPtrs.front(), intake->timeBase);
+        auto back = queueItemTimestamp(intake->packetPtrs.back(), intake->timeBase);
+        if (front != Utils::s_invalidQueueTimestamp && back != Utils::s_invalidQueueTimestamp
+            && back > front) {
+            duration += back - front;
+        }
+    }
+    return duration;
+}
+
+void PacketDispatcher::wait(int milliseconds)
+{
+    auto woken = d_ptr->wakeCount.load();
+    auto bytes = d_ptr->bytes;
+    dispatch();
+    if (isEmpty() || d_ptr->bytes < bytes) {
+        return;
+    }
+    QMutexLocker locker(&d_ptr->mutex);
+    d_ptr->waiting.store(true);
+    if (d_ptr->wakeCount.load() == woken) {
+        d_ptr->condition.wait(&d_ptr->mutex, milliseconds);
+    }
+    d_ptr->waiting.store(false);
+}
+
+// called for every packet a decoder takes, the lock is only taken when the reader waits
+void PacketDispatcher::wakeUp()
+{
+    d_ptr->wakeCount.fetch_add(1);
+    if (!d_ptr->waiting.load()) {
+        return;
+    }
+    QMutexLocker locker(&d_ptr->mutex);
+    d_ptr->condition.wakeAll();
+}
+
+} // namespace Ffmpeg
@@ -0,0 +1,59 @@
+#ifndef PACKETDISPATCHER_HPP
+#define PACKETDISPATCHER_HPP
+
+#include "decoder.h"
+
+namespace Ffmpeg {
+
+// Buffered intake per stream between the demuxer and the packet decoders.
+// A packet waits in the intake of its stream while that decoder's queue is full, so a full video
+// queue no longer holds back audio. The reader only stalls when the intakes together hold more
+// than the byte budget, and never while the decoder of the master stream runs dry.
+// Player thread only, except wakeUp().
+class PacketDispatcher
+{
+    Q_DISABLE_COPY_MOVE(PacketDispatcher)
+public:
+    PacketDispatcher();
+    ~PacketDispatcher();
+
+    void setByteBudget(qint64 bytes);
+    [[nodiscard]] auto byteBudget() const -> qint64;
+
+    // nothing for a context without a stream
+    void addStream(AVContextInfo *contextInfo, Decoder<PacketPtr> *decoder);
+    // the stream driving the master clock, it is read for even over the budget
+    void setMasterStream(int streamIndex);
+    // drops the streams and their intakes
+    void reset();
+
+    // false if no stream was added for the packet
+    auto append(const PacketPtr &packetPtr) -> bool;
+    // hands waiting packets to the decoders without blocking
+    void dispatch();
+    // drops the waiting packets, after a seek
+    void clear();
+
+    // the demuxer may read another packet
+    [[nodiscard]] auto canRead() const -> bool;
+    [[nodiscard]] auto isEmpty() const -> bool;
+    [[nodiscard]] auto bytes() const -> qint64;
+    // microseconds of the master stream queued in its decoder and intake. The decoded frames
+    // in the display queue and the audio sink (a few hundred milliseconds at most) are not
+    // counted, so buffering starts slightly early rather than late.
+    [[nodiscard]] auto bufferedDuration() const -> qint64;
+
+    // dispatches, then blocks until a decoder took a packet, wakeUp() or the timeout unless
+    // that made progress
+    void wait(int milliseconds);
+    // thread safe
+    void wakeUp();
+
+private:
+    class PacketDispatcherPrivate;
+    QScopedPointer<PacketDispatcherPrivate> d_ptr;
+};
+
+} // namespace Ffmpeg
+
+#endif // PACKETDISPATCHER_HPP
@@ -2,11 +2,14 @@
 #include "audiodecoder.h"
 #include "avcontextinfo.h"
 #include "averrormanager.hpp"
+#include "bufferingcontroller.hpp"
 #include "clock.hpp"
 #include "codeccontext.h"
 #include "formatcontext.h"
 #include "mediainfo.hpp"
 #include "packet.h"
+#include "packetcache.hpp"
+#include "packetdispatcher.hpp"
 #include "subtitledecoder.h"
 #include "videodecoder.h"
 
@@ -20,13 +23,22 @@
 #include <videorender/videorender.hpp>
 
 #include <QImage>
+#include <QUrl>
+
+#include <deque>
 
 extern "C" {
 #include <libavformat/avformat.h>
+#include <libavutil/time.h>
 }
 
 namespace Ffmpeg {
 
+// packets waiting for the decoders of a live input
+static constexpr qint64 s_liveByteBudget = 1024 * 1024;
+// reception times kept for the live latency, far more master packets than the threshold holds
+static constexpr size_t s_maxMasterArrivals = 1024;
+
 class Player::PlayerPrivate
 {
 public:
@@ -39,9 +51,15 @@ public:
         videoInfo = new AVContextInfo(q_ptr);
         subtitleInfo = new AVContextInfo(q_ptr);
 
-        audioDecoder = new AudioDecoder(q_ptr);
-        videoDecoder = new VideoDecoder(q_ptr);
-        subtitleDecoder = new SubtitleDecoder(q_ptr);
+        clockDomain = new ClockDomain(q_ptr);
+
+        audioDecoder = new AudioDecoder(clockDomain, q_ptr);
+        videoDecoder = new VideoDecoder(clockDomain, q_ptr);
+        subtitleDecoder = new SubtitleDecoder(clockDomain, q_ptr);
+        // a decoder taking a packet makes room for the intake of its stream
+        audioDecoder->setUpstream([this] { packetDispatcher.wakeUp(); });
+        videoDecoder->setUpstream([this] { packetDispatcher.wakeUp(); });
+        subtitleDecoder->setUpstream([this] { packetDispatcher.wakeUp(); });
 
         QObject::connect(AVErrorManager::instance(),
                          &AVErrorManager::error,
@@ -55,6 +73,11 @@ public:
     {
         isOpen = false;
         //初始化pFormatCtx结构
+        liveSession = liveMode.load();
+        formatCtx->setLowLatency(liveSession);
+        formatCtx->setPrefetchSize(prefetchSize.load());
+        formatCtx->setMemoryMapping(memoryMapping.load());
+        formatCtx->setHttpCache(httpCache.load());
         if (!formatCtx->openFilePath(filepath)) {
             return false;
         }
@@ -71,9 +94,15 @@ public:
         }
         isOpen = true;
         formatCtx->dumpFormat();
+        // seeks and previews of this file use the keyframes, containers without an index get
+        // them from a scan
+        if (auto keyframeIndex = formatCtx->keyframeIndex(); !keyframeIndex.isNull()) {
+            keyframeIndex->scanInBackground();
+        }
 
         addPropertyChangeEvent(new DurationEvent(formatCtx->duration()));
-        q_ptr->onPositionChanged(0);
+        clockDomain->setPosition(0);
+        checkPositionChanged();
 
         return true;
     }
@@ -160,18 +189,41 @@ public:
             {audioInfo->index(), videoInfo->index(), subtitleInfo->index()});
         formatCtx->seekFirstFrame();
 
+        videoDecoder->setLowLatency(liveSession);
+        subtitleDecoder->setLowLatency(liveSession);
+        audioDecoder->setLowLatency(liveSession);
         videoDecoder->startDecoder(formatCtx, videoInfo);
         subtitleDecoder->startDecoder(formatCtx, subtitleInfo);
         audioDecoder->startDecoder(formatCtx, audioInfo);
 
+        packetDispatcher.reset();
+        packetDispatcher.setByteBudget(liveSession ? s_liveByteBudget : demuxByteBudget.load());
+        packetDispatcher.addStream(audioInfo, audioDecoder);
+        packetDispatcher.addStream(videoInfo, videoDecoder);
+        packetDispatcher.addStream(subtitleInfo, subtitleDecoder);
+
         if (audioInfo->isIndexVaild()) {
             audioDecoder->setMasterClock();
+            packetDispatcher.setMasterStream(audioInfo->index());
+            masterInfo = audioInfo;
         } else if (videoInfo->isIndexVaild()) {
             videoDecoder->setMasterClock();
+            packetDispatcher.setMasterStream(videoInfo->index());
+            masterInfo = videoInfo;
         } else {
             Q_ASSERT(false);
         }
-        Clock::master()->invalidate();
+        clockDomain->master()->invalidate();
+
+        networkInput = !QUrl::fromUserInput(filepath).isLocalFile();
+        bufferingController.reset(formatCtx->avFormatContext()->bit_rate);
+        healthTimer.invalidate();
+
+        masterArrivals.clear();
+        waitKeyframe = false;
+        flushPosition = clockDomain->position();
+        liveDropNum = 0;
+        latencyTimer.invalidate();
 
         speedPtr.reset(new Utils::Speed);
         speedTimer.restart();
@@ -181,6 +233,7 @@ public:
     {
         speedTimer.invalidate();
         speedPtr.reset();
+        packetDispatcher.reset();
 
         videoDecoder->stopDecoder();
         subtitleDecoder->stopDecoder();
@@ -199,49 +252,229 @@ public:
     void playVideo()
     {
         Q_ASSERT(isOpen);
+        // a live input is never seeked back into
+        packetCache.setMaxBytes(liveSession ? 0 : packetCacheSize.load());
         setMediaState(Playing);
         startDecoder();
 
         while (runing) {
             processEvent();
+            checkPositionChanged();
+            checkLiveLatency();
 
-            PacketPtr packetPtr(new Packet);
-            if (!formatCtx->readFrame(packetPtr.data())) {
-                break;
+            packetDispatcher.dispatch();
+            updateBuffering(packetDispatcher.canRead());
+            if (!packetDispatcher.canRead()) {
+                packetDispatcher.wait(s_waitQueueEmptyMilliseconds);
+                continue;
+            }
+
+            PacketPtr packetPtr;
+            auto replayed = packetCache.takeReplay(packetPtr);
+            if (!replayed) {
+                packetPtr = packetPool.acquire();
+                auto readStart = av_gettime_relative();
+                if (!formatCtx->readFrame(packetPtr.data())) {
+                    break;
+                }
+                bufferingController.addRead(packetPtr->avPacket()->size,
+                                            av_gettime_relative() - readStart);
+                addSpeedChangeEvent(packetPtr->avPacket()->size);
+            }
+            if (liveSession && !checkLivePacket(packetPtr)) {
+                continue;
             }
-            addSpeedChangeEvent(packetPtr->avPacket()->size);
 
             auto stream_index = packetPtr->streamIndex();
             if (!formatCtx->checkPktPlayRange(packetPtr.data())) {
             } else if (stream_index == audioInfo->index()) { // 如果是音频数据
-                audioDecoder->append(packetPtr);
+                if (!replayed) {
+                    packetCache.append(packetPtr,
+                                       audioInfo->timebase(),
+                                       !videoInfo->isIndexVaild());
+                }
+                packetDispatcher.append(packetPtr);
             } else if (stream_index == videoInfo->index()
                        && ((videoInfo->stream()->disposition & AV_DISPOSITION_ATTACHED_PIC)
                            == 0)) { // 如果是视频数据
-                videoDecoder->append(packetPtr);
+                if (!replayed) {
+                    packetCache.append(packetPtr, videoInfo->timebase(), packetPtr->isKey());
+                }
+                packetDispatcher.append(packetPtr);
             } else if (stream_index == subtitleInfo->index()) { // 如果是字幕数据
-                subtitleDecoder->append(packetPtr);
+                // replayed with the audio and video after a cached seek, never a seek point
+                if (!replayed) {
+                    packetCache.append(packetPtr, subtitleInfo->timebase(), false);
+                }
+                packetDispatcher.append(packetPtr);
             }
         }
+        if (bufferingController.isBuffering()) {
+            // nothing more to wait for, play out what is queued
+            bufferingController.stopBuffering();
+            setBuffering(false);
+        }
+        while (runing && !packetDispatcher.isEmpty()) {
+            packetDispatcher.wait(s_waitQueueEmptyMilliseconds);
+            checkPositionChanged();
+        }
         while (runing && (videoDecoder->size() > 0 || audioDecoder->size() > 0)) {
             msleep(s_waitQueueEmptyMilliseconds);
+            checkPositionChanged();
         }
         stopDecoder();
         setMediaState(Stopped);
-        qInfo() << "play finish";
+        qInfo() << "play finish, packets created:" << packetPool.createdCount()
+                << "reused:" << packetPool.reusedCount();
+        if (liveSession) {
+            qInfo() << "Live drops to newest:" << liveDropNum;
+        }
     }
 
     auto setMediaIndex(AVContextInfo *contextInfo, int index) const -> bool
     {
         contextInfo->setIndex(index);
         contextInfo->setStream(formatCtx->stream(index));
-        if (!contextInfo->initDecoder(formatCtx->guessFrameRate(index))) {
+        auto threadingPolicy = liveSession ? ThreadingPolicy::live() : q_ptr->threadingPolicy();
+        if (!contextInfo->initDecoder(formatCtx->guessFrameRate(index), threadingPolicy)) {
             return false;
         }
         return contextInfo->openCodec(gpuDecode ? AVContextInfo::GpuType::GpuDecode
                                                 : AVContextInfo::GpuType::NotUseGpu);
     }
 
+    // The master clock publishes its pts through the clock domain, report it to the property
+    // events once it moved by a second
+    void checkPositionChanged()
+    {
+        auto position = clockDomain->position();
+        if (qAbs(position - reportedPosition) < AV_TIME_BASE) {
+            return;
+        }
+        reportedPosition = position;
+        addPropertyChangeEvent(new PositionEvent(position));
+    }
+
+    // Network inputs only. The look-ahead follows the throughput, and playback waits in the
+    // Buffering state before the master stream runs dry.
+    void updateBuffering(bool canFill)
+    {
+        if (!networkInput || liveSession || !adaptiveBuffering.load()) {
+            return;
+        }
+        auto changed = bufferingController.update(packetDispatcher.bufferedDuration(), canFill);
+        packetDispatcher.setByteBudget(
+            qMax(demuxByteBudget.load(), bufferingController.lookAheadBytes()));
+        if (changed) {
+            setBuffering(bufferingController.isBuffering());
+        }
+        if (changed || !healthTimer.isValid() || healthTimer.hasExpired(500)) {
+            addPropertyChangeEvent(new BufferHealthEvent(bufferingController.bufferedDuration(),
+                                                         bufferingController.lookAheadDuration()));
+            healthTimer.restart();
+        }
+    }
+
+    // Live mode, false if the packet is dropped: video waits for a keyframe after a drop to the
+    // newest packets
+    auto checkLivePacket(const PacketPtr &packetPtr) -> bool
+    {
+        auto streamIndex = packetPtr->streamIndex();
+        if (streamIndex == masterInfo->index()) {
+            auto pts = queueItemTimestamp(packetPtr, masterInfo->timebase());
+            if (pts != Utils::s_invalidQueueTimestamp) {
+                masterArrivals.emplace_back(pts, av_gettime_relative());
+                while (masterArrivals.size() > s_maxMasterArrivals) {
+                    masterArrivals.pop_front();
+                }
+            }
+        }
+        if (!waitKeyframe || streamIndex != videoInfo->index()) {
+            return true;
+        }
+        waitKeyframe = !packetPtr->isKey();
+        return !waitKeyframe;
+    }
+
+    // Live mode: drops what is queued once playback is further behind the newest packet than
+    // the threshold, and publishes the latency once a second. Sources with a wallclock, like
+    // rtsp with RTCP sender reports, give the latency from capture, the others from the
+    // reception of the master packet on screen.
+    void checkLiveLatency()
+    {
+        if (!liveSession || masterArrivals.empty()) {
+            return;
+        }
+        auto newestPts = masterArrivals.back().first;
+        auto position = clockDomain->position();
+        // the master clock showed a frame since the last flush, position is on screen
+        auto playing = position != flushPosition;
+        auto latency = packetDispatcher.bufferedDuration();
+        if (playing) {
+            latency = qMax(latency, newestPts - position);
+        }
+        if (latency > liveLatencyThreshold.load()) {
+            dropToNewest();
+            return;
+        }
+        if (!playing || (latencyTimer.isValid() && !latencyTimer.hasExpired(1000))) {
+            return;
+        }
+        latencyTimer.restart();
+        while (masterArrivals.size() > 1 && masterArrivals[1].first <= position) {
+            masterArrivals.pop_front();
+        }
+        if (masterArrivals.front().first <= position) {
+            latency = av_gettime_relative() - masterArrivals.front().second;
+        }
+        auto *avFormatContext = formatCtx->avFormatContext();
+        auto glassToGlass = avFormatContext->start_time_realtime != AV_NOPTS_VALUE;
+        if (glassToGlass) {
+            auto startTime = avFormatContext->start_time != AV_NOPTS_VALUE
+                                 ? avFormatContext->start_time
+                                 : 0;
+            latency = av_gettime() - (avFormatContext->start_time_realtime + position - startTime);
+        }
+        liveLatency.store(latency);
+        addPropertyChangeEvent(new LiveLatencyEvent(latency, glassToGlass));
+    }
+
+    // the decoders drop what they queued like for a seek, the demuxer reads on
+    void dropToNewest()
+    {
+        auto position = masterArrivals.back().first;
+        masterArrivals.erase(masterArrivals.begin(), std::prev(masterArrivals.end()));
+        auto *seekEvent = new SeekEvent(position);
+        seekEvent->setAccurate(false);
+        EventPtr eventPtr(seekEvent);
+        q_ptr->blockSignals(true);
+        flushDecoders(eventPtr);
+        packetDispatcher.clear();
+        flushCodecs();
+        q_ptr->blockSignals(false);
+        waitKeyframe = videoInfo->isIndexVaild();
+        clockDomain->setPosition(position);
+        reportedPosition = position;
+        flushPosition = position;
+        clockDomain->master()->invalidate();
+        liveDropNum++;
+        qDebug() << "Live latency over the threshold, dropped to the newest packets";
+    }
+
+    // the clocks stand still and the displays hold their frames while waiting, playback resumes
+    // in sync instead of resetting the clocks and dropping the late frames
+    void setBuffering(bool buffering)
+    {
+        EventPtr eventPtr(new BufferingEvent(buffering));
+        audioDecoder->addEvent(eventPtr);
+        videoDecoder->addEvent(eventPtr);
+        subtitleDecoder->addEvent(eventPtr);
+        if (!buffering) {
+            clockDomain->master()->invalidate();
+        }
+        setMediaState(buffering ? MediaState::Buffering : MediaState::Playing);
+    }
+
     void setMediaState(MediaState mediaState_)
     {
         mediaState = mediaState_;
@@ -270,10 +503,22 @@ public:
 
     void addEvent(const EventPtr &eventPtr)
     {
+        if (eventPtr->type() == Event::EventType::Seek) {
+            // only the newest target matters, seeks still waiting would each block the demuxer
+            auto coalesced = eventQueue.removeIf([](const EventPtr &queued) {
+                return queued->type() == Event::EventType::Seek
+                       || queued->type() == Event::EventType::SeekRelative;
+            });
+            if (coalesced > 0) {
+                qDebug() << "Seek coalesced:" << coalesced;
+            }
+        }
         eventQueue.append(eventPtr);
         while (eventQueue.size() > maxEventQueueSize.load()) {
             eventQueue.take();
         }
+        // the demux loop may be waiting for the decoders
+        packetDispatcher.wakeUp();
         if (!paused.load()) {
             return;
         }
@@ -324,6 +569,14 @@ public:
             setMediaState(MediaState::Pausing);
             addPropertyChangeEvent(new CacheSpeedEvent(0));
         } else if (q_ptr->isRunning()) {
+            // the clocks run again, buffering starts over if still short of data
+            if (bufferingController.isBuffering()) {
+                bufferingController.stopBuffering();
+                EventPtr bufferingEventPtr(new BufferingEvent(false));
+                audioDecoder->addEvent(bufferingEventPtr);
+                videoDecoder->addEvent(bufferingEventPtr);
+                subtitleDecoder->addEvent(bufferingEventPtr);
+            }
             setMediaState(isOpen ? MediaState::Playing : MediaState::Opening);
         } else {
             setMediaState(MediaState::Stopped);
@@ -336,16 +589,14 @@ public:
             QMutexLocker locker(&mutex);
             waitCondition.wait(&mutex);
         } else {
-            Clock::master()->invalidate();
+            clockDomain->master()->invalidate();
         }
     }
 
-    void processSeekEvent(const EventPtr &eventPtr)
+    // hands the seek event to the decoders and waits until they dropped what they queued
+    void flushDecoders(const EventPtr &eventPtr)
     {
-        QElapsedTimer timer;
-        timer.start();
-        q_ptr->blockSignals(true);
-        Clock::globalSerialRef();
+        clockDomain->serialRef();
         int count = 0;
         if (audioInfo->isIndexVaild()) {
             count++;
@@ -361,10 +612,11 @@ public:
         audioDecoder->addEvent(eventPtr);
         videoDecoder->addEvent(eventPtr);
         subtitleDecoder->addEvent(eventPtr);
-        auto position = seekEvent->position();
         seekEvent->wait();
+    }
 
-        formatCtx->seek(position, position < this->position);
+    void flushCodecs()
+    {
         if (audioInfo->isIndexVaild()) {
             audioInfo->codecCtx()->flush();
         }
@@ -374,9 +626,33 @@ public:
         if (subtitleInfo->isIndexVaild()) {
             subtitleInfo->codecCtx()->flush();
         }
+    }
+
+    void processSeekEvent(const EventPtr &eventPtr)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        q_ptr->blockSignals(true);
+        auto *seekEvent = dynamic_cast<SeekEvent *>(eventPtr.data());
+        if (!accurateSeek.load()) {
+            seekEvent->setAccurate(false);
+        }
+        auto position = seekEvent->position();
+        flushDecoders(eventPtr);
+
+        packetDispatcher.clear();
+        bufferingController.seeked();
+        if (packetCache.seek(position)) {
+            qInfo() << "Seek served from the packet cache";
+        } else {
+            formatCtx->seek(position, position < clockDomain->position());
+            packetCache.clear();
+        }
+        flushCodecs();
         q_ptr->blockSignals(false);
-        this->position = position;
-        Clock::master()->invalidate();
+        clockDomain->setPosition(position);
+        reportedPosition = position;
+        clockDomain->master()->invalidate();
         qInfo() << "Seek To: "
                 << QTime::fromMSecsSinceStartOfDay(position / 1000).toString("hh:mm:ss.zzz")
                 << "Seeked elapsed: " << timer.elapsed() << "ms";
@@ -388,7 +664,7 @@ public:
     {
         auto *seekRelativeEvent = dynamic_cast<SeekRelativeEvent *>(eventPtr.data());
         auto relativePosition = seekRelativeEvent->relativePosition();
-        auto position = this->position + relativePosition * AV_TIME_BASE;
+        auto position = clockDomain->position() + relativePosition * AV_TIME_BASE;
         if (position < 0) {
             position = 0;
         } else if (position > q_ptr->duration()) {
@@ -410,7 +686,7 @@ public:
         meidaIndex.videoindex = videoInfo->index();
         meidaIndex.subtitleindex = subtitleInfo->index();
 
-        auto position = this->position - 5 * AV_TIME_BASE;
+        auto position = clockDomain->position() - 5 * AV_TIME_BASE;
         if (position < 0) {
             position = 0;
         }
@@ -430,7 +706,7 @@ public:
         meidaIndex.videoindex = videoInfo->index();
         meidaIndex.subtitleindex = subtitleInfo->index();
 
-        auto position = this->position - 5 * AV_TIME_BASE;
+        auto position = clockDomain->position() - 5 * AV_TIME_BASE;
         if (position < 0) {
             position = 0;
         }
@@ -463,7 +739,6 @@ public:
 
     void processCloseMediaEvent()
     {
-        q_ptr->buildConnect(false);
         runing.store(false);
         wakePause();
         if (q_ptr->isRunning()) {
@@ -478,10 +753,10 @@ public:
         formatCtx->close();
     }
 
-    static void processSpeedEvent(const EventPtr &eventPtr)
+    void processSpeedEvent(const EventPtr &eventPtr) const
     {
         auto *speedEvent = dynamic_cast<SpeedEvent *>(eventPtr.data());
-        Clock::setSpeed(speedEvent->speed());
+        clockDomain->setSpeed(speedEvent->speed());
     }
 
     void processVolumeEvent(const EventPtr &eventPtr) const
@@ -497,17 +772,49 @@ public:
     AVContextInfo *videoInfo;
     AVContextInfo *subtitleInfo;
 
+    ClockDomain *clockDomain;
     AudioDecoder *audioDecoder;
     VideoDecoder *videoDecoder;
     SubtitleDecoder *subtitleDecoder;
 
     MediaIndex meidaIndex;
 
+    PacketPool packetPool;
+    PacketCache packetCache;
+    std::atomic<qint64> packetCacheSize = 64 * 1024 * 1024;
+    PacketDispatcher packetDispatcher;
+    std::atomic<qint64> demuxByteBudget = 16 * 1024 * 1024;
+    std::atomic<qint64> prefetchSize = 0;
+    std::atomic_bool memoryMapping = false;
+    std::atomic_bool httpCache = false;
+    BufferingController bufferingController;
+    std::atomic_bool liveMode = false;
+    std::atomic<qint64> liveLatencyThreshold = 300 * 1000;
+    std::atomic<qint64> liveLatency = 0;
+    std::atomic_bool adaptiveBuffering = true;
+    // player thread only
+    bool networkInput = false;
+    QElapsedTimer healthTimer;
+    bool liveSession = false;
+    AVContextInfo *masterInfo = nullptr;
+    // microseconds, pts and av_gettime_relative() of the master packets read, the newest last,
+    // those before the one on screen are dropped
+    std::deque<std::pair<qint64, qint64>> masterArrivals;
+    bool waitKeyframe = false;
+    // position at the start or the last drop to the newest packets
+    qint64 flushPosition = 0;
+    quint64 liveDropNum = 0;
+    QElapsedTimer latencyTimer;
+
     QString filepath;
     std::atomic_bool isOpen = true;
     std::atomic_bool runing = true;
     bool gpuDecode = true;
-    qint64 position = 0;
+    std::atomic_bool accurateSeek = true;
+    mutable QMutex threadingMutex;
+    ThreadingPolicy threadingPolicy = ThreadingPolicy::playback();
+    // last position sent as PositionEvent, player thread only
+    qint64 reportedPosition = 0;
     std::atomic<MediaState> mediaState = MediaState::Stopped;
 
     std::atomic_bool paused = false;
@@ -530,8 +837,6 @@ Player::Player(QObject *parent)
     , d_ptr(new PlayerPrivate(this))
 {
     av_log_set_level(AV_LOG_INFO);
-
-    buildConnect();
 }
 
 Player::~Player()
@@ -546,29 +851,18 @@ auto Player::filePath() const -> QString &
 
 void Player::onPlay()
 {
-    buildConnect(true);
     d_ptr->runing = true;
     start();
 }
 
-void Player::onPositionChanged(qint64 position)
-{
-    auto diff = (position - d_ptr->position) / AV_TIME_BASE;
-    if (qAbs(diff) < 1) {
-        return;
-    }
-    d_ptr->position = position;
-    d_ptr->addPropertyChangeEvent(new PositionEvent(position));
-}
-
 auto Player::isOpen() -> bool
 {
     return d_ptr->isOpen;
 }
 
-auto Player::speed() -> double
+auto Player::speed() const -> double
 {
-    return Clock::speed();
+    return d_ptr->clockDomain->speed();
 }
 
 auto Player::isGpuDecode() -> bool
@@ -588,7 +882,7 @@ auto Player::duration() const -> qint64
 
 auto Player::position() const -> qint64
 {
-    return d_ptr->position;
+    return d_ptr->clockDomain->position();
 }
 
 auto Player::fames() const -> qint64
@@ -638,6 +932,130 @@ auto Player::videoRenders() -> QVector<VideoRender *>
     return d_ptr->videoRenders;
 }
 
+void Player::setUseSharedExecutor(bool use)
+{
+    d_ptr->audioDecoder->setUseSharedExecutor(use);
+    d_ptr->videoDecoder->setUseSharedExecutor(use);
+    d_ptr->subtitleDecoder->setUseSharedExecutor(use);
+}
+
+auto Player::useSharedExecutor() const -> bool
+{
+    return d_ptr->videoDecoder->useSharedExecutor();
+}
+
+void Player::setAccurateSeek(bool accurate)
+{
+    d_ptr->accurateSeek.store(accurate);
+}
+
+auto Player::isAccurateSeek() const -> bool
+{
+    return d_ptr->accurateSeek.load();
+}
+
+void Player::setThreadingPolicy(const ThreadingPolicy &threadingPolicy)
+{
+    QMutexLocker locker(&d_ptr->threadingMutex);
+    d_ptr->threadingPolicy = threadingPolicy;
+}
+
+auto Player::threadingPolicy() const -> ThreadingPolicy
+{
+    QMutexLocker locker(&d_ptr->threadingMutex);
+    return d_ptr->threadingPolicy;
+}
+
+void Player::setPacketCacheSize(qint64 bytes)
+{
+    d_ptr->packetCacheSize.store(bytes);
+}
+
+auto Player::packetCacheSize() const -> qint64
+{
+    return d_ptr->packetCacheSize.load();
+}
+
+void Player::setDemuxByteBudget(qint64 bytes)
+{
+    d_ptr->demuxByteBudget.store(bytes);
+}
+
+auto Player::demuxByteBudget() const -> qint64
+{
+    return d_ptr->demuxByteBudget.load();
+}
+
+void Player::setPrefetchSize(qint64 bytes)
+{
+    d_ptr->prefetchSize.store(bytes);
+}
+
+auto Player::prefetchSize() const -> qint64
+{
+    return d_ptr->prefetchSize.load();
+}
+
+void Player::setMemoryMapping(bool memoryMapping)
+{
+    d_ptr->memoryMapping.store(memoryMapping);
+}
+
+auto Player::memoryMapping() const -> bool
+{
+    return d_ptr->memoryMapping.load();
+}
+
+void Player::setHttpCache(bool httpCache)
+{
+    d_ptr->httpCache.store(httpCache);
+}
+
+auto Player::httpCache() const -> bool
+{
+    return d_ptr->httpCache.load();
+}
+
+void Player::setAdaptiveBuffering(bool enable)
+{
+    d_ptr->adaptiveBuffering.store(enable);
+}
+
+auto Player::isAdaptiveBuffering() const -> bool
+{
+    return d_ptr->adaptiveBuffering.load();
+}
+
+void Player::setLiveMode(bool live)
+{
+    d_ptr->liveMode.store(live);
+}
+
+auto Player::isLiveMode() const -> bool
+{
+    return d_ptr->liveMode.load();
+}
+
+void Player::setLiveLatencyThreshold(qint64 threshold)
+{
+    d_ptr->liveLatencyThreshold.store(threshold);
+}
+
+auto Player::liveLatencyThreshold() const -> qint64
+{
+    return d_ptr->liveLatencyThreshold.load();
+}
+
+auto Player::liveLatency() const -> qint64
+{
+    return d_ptr->liveLatency.load();
+}
+
+auto Player::packetPool() -> PacketPool *
+{
+    return &d_ptr->packetPool;
+}
+
 void Player::setPropertyEventQueueMaxSize(size_t size)
 {
     d_ptr->maxPropertyEventQueueSize.store(size);
@@ -701,29 +1119,4 @@ void Player::run()
     d_ptr->playVideo();
 }
 
-void Player::buildConnect(bool state)
-{
-    if (state) {
-        connect(d_ptr->audioDecoder,
-                &AudioDecoder::positionChanged,
-                this,
-                &Player::onPositionChanged,
-                Qt::UniqueConnection);
-        connect(d_ptr->videoDecoder,
-                &VideoDecoder::positionChanged,
-                this,
-                &Player::onPositionChanged,
-                Qt::UniqueConnection);
-    } else {
-        disconnect(d_ptr->audioDecoder,
-                   &AudioDecoder::positionChanged,
-                   this,
-                   &Player::onPositionChanged);
-        disconnect(d_ptr->videoDecoder,
-                   &VideoDecoder::positionChanged,
-                   this,
-                   &Player::onPositionChanged);
-    }
-}
-
 } // namespace Ffmpeg
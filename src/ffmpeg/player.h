@@ -2,6 +2,7 @@
 #define PLAYER_H
 
 #include "mediainfo.hpp"
+#include "threadingpolicy.hpp"
 
 #include <ffmpeg/event/event.hpp>
 
@@ -9,6 +10,7 @@
 
 namespace Ffmpeg {
 
+class PacketPool;
 class VideoRender;
 
 class FFMPEG_EXPORT Player : public QThread
@@ -20,12 +22,12 @@ public:
 
     [[nodiscard]] auto filePath() const -> QString &;
     auto isOpen() -> bool;
-    static auto speed() -> double;
+    [[nodiscard]] auto speed() const -> double;
     auto isGpuDecode() -> bool;
     auto mediaState() -> MediaState;
 
     [[nodiscard]] auto duration() const -> qint64; // microsecond
-    [[nodiscard]] auto position() const -> qint64; // microsecond
+    [[nodiscard]] auto position() const -> qint64; // microsecond, lock-free
     [[nodiscard]] auto fames() const -> qint64;
     [[nodiscard]] auto resolutionRatio() const -> QSize;
     [[nodiscard]] auto fps() const -> double;
@@ -38,6 +40,63 @@ public:
     void setVideoRenders(const QVector<VideoRender *> &videoRenders);
     auto videoRenders() -> QVector<VideoRender *>;
 
+    // Run the decoder/display stages as tasks on the shared DecoderExecutor instead of one
+    // thread per stage, takes effect on the next open
+    void setUseSharedExecutor(bool use);
+    [[nodiscard]] auto useSharedExecutor() const -> bool;
+
+    // seeks start at the frame at the position instead of the keyframe before it, on by default
+    void setAccurateSeek(bool accurate);
+    [[nodiscard]] auto isAccurateSeek() const -> bool;
+
+    // threads of the audio/video/subtitle decoders, takes effect on the next open
+    void setThreadingPolicy(const ThreadingPolicy &threadingPolicy);
+    [[nodiscard]] auto threadingPolicy() const -> ThreadingPolicy;
+
+    // Bytes of recently read audio and video packets kept for seeks close to the position,
+    // 0 disables, takes effect on the next open
+    void setPacketCacheSize(qint64 bytes);
+    [[nodiscard]] auto packetCacheSize() const -> qint64;
+
+    // Bytes of packets waiting for a full decoder queue before the demuxer stops reading,
+    // the stream of the master clock is read for regardless, takes effect on the next open
+    void setDemuxByteBudget(qint64 bytes);
+    [[nodiscard]] auto demuxByteBudget() const -> qint64;
+
+    // Bytes the input is read ahead of the demuxer on an I/O thread, absorbs disk and network
+    // stalls, 0 disables, takes effect on the next open
+    void setPrefetchSize(qint64 bytes);
+    [[nodiscard]] auto prefetchSize() const -> qint64;
+
+    // Local files are read through a memory mapping, off by default, a file truncated while it
+    // is played crashes with SIGBUS, takes effect on the next open
+    void setMemoryMapping(bool memoryMapping);
+    [[nodiscard]] auto memoryMapping() const -> bool;
+
+    // http(s) resources are cached on disk within HttpCacheIO::cacheBudget(), off by default,
+    // a resource changed on the server with the same length is served stale, takes effect on
+    // the next open
+    void setHttpCache(bool httpCache);
+    [[nodiscard]] auto httpCache() const -> bool;
+
+    // Network inputs size the demux look-ahead from throughput and bitrate and wait in the
+    // Buffering state before an underrun, reported by BufferHealthEvent, on by default
+    void setAdaptiveBuffering(bool enable);
+    [[nodiscard]] auto isAdaptiveBuffering() const -> bool;
+
+    // Live inputs: minimal probing, no demuxer buffering, low delay decoding, tiny queues, and
+    // what is queued is dropped once playback lags the newest packet by the threshold.
+    // Takes effect on the next open
+    void setLiveMode(bool live);
+    [[nodiscard]] auto isLiveMode() const -> bool;
+    void setLiveLatencyThreshold(qint64 threshold); // microseconds, 300 ms by default
+    [[nodiscard]] auto liveLatencyThreshold() const -> qint64;
+    // microseconds, the last LiveLatencyEvent
+    [[nodiscard]] auto liveLatency() const -> qint64;
+
+    // allocation counters of the demux loop
+    auto packetPool() -> PacketPool *;
+
     void setPropertyEventQueueMaxSize(size_t size);
     [[nodiscard]] auto propertEventyQueueMaxSize() const -> size_t;
     [[nodiscard]] auto propertyChangeEventSize() const -> size_t;
@@ -51,9 +110,6 @@ public:
 public slots:
     void onPlay();
 
-private slots:
-    void onPositionChanged(qint64 position);
-
 signals:
     void eventIncrease();
 
@@ -61,8 +117,6 @@ protected:
     void run() override;
 
 private:
-    void buildConnect(bool state = true);
-
     class PlayerPrivate;
     QScopedPointer<PlayerPrivate> d_ptr;
 };
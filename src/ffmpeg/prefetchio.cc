@@ -0,0 +1,254 @@
+#include "prefetchio.hpp"
+#include "averrormanager.hpp"
+
+#include <QWaitCondition>
+
+extern "C" {
+#include <libavformat/avio.h>
+#include <libavutil/error.h>
+#include <libavutil/mem.h>
+}
+
+namespace Ffmpeg {
+
+// what the demuxer gets per read callback, and what the read-ahead thread asks for at once
+static constexpr auto s_ioBufferSize = 64 * 1024;
+static constexpr auto s_blockSize = 256 * 1024;
+
+class PrefetchIO::PrefetchIOPrivate
+{
+public:
+    explicit PrefetchIOPrivate(PrefetchIO *q)
+        : q_ptr(q)
+    {}
+
+    static auto readPacket(void *opaque, uint8_t *buf, int bufSize) -> int
+    {
+        return static_cast<PrefetchIOPrivate *>(opaque)->read(buf, bufSize);
+    }
+
+    static auto seekPacket(void *opaque, int64_t offset, int whence) -> int64_t
+    {
+        return static_cast<PrefetchIOPrivate *>(opaque)->seek(offset, whence);
+    }
+
+    // bytes behind the read position the ring keeps for short backward seeks
+    [[nodiscard]] auto backReserve() const -> qint64 { return capacity / 4; }
+
+    auto read(uint8_t *buf, int bufSize) -> int
+    {
+        QMutexLocker locker(&mutex);
+        while (!stopped && readPos >= windowEnd && !eof && error == 0) {
+            readable.wait(&mutex);
+        }
+        if (stopped) {
+            return AVERROR_EXIT;
+        }
+        if (readPos >= windowEnd) {
+            return error != 0 ? error : AVERROR_EOF;
+        }
+        auto size = static_cast<int>(qMin<qint64>(bufSize, windowEnd - readPos));
+        auto index = readPos % capacity;
+        auto first = static_cast<int>(qMin<qint64>(size, capacity - index));
+        memcpy(buf, ring.data() + index, first);
+        memcpy(buf + first, ring.data(), size - first);
+        readPos += size;
+        writable.wakeOne();
+        return size;
+    }
+
+    auto seek(int64_t offset, int whence) -> int64_t
+    {
+        QMutexLocker locker(&mutex);
+        switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE: return fileSize;
+        case SEEK_SET: break;
+        case SEEK_CUR: offset += readPos; break;
+        case SEEK_END:
+            if (fileSize < 0) {
+                return AVERROR(ENOSYS);
+            }
+            offset += fileSize;
+            break;
+        default: return AVERROR(EINVAL);
+        }
+        if (offset < 0) {
+            return AVERROR(EINVAL);
+        }
+        if (offset < windowStart || offset > windowEnd) {
+            // outside the ring, the read-ahead thread starts over at offset
+            generation++;
+            windowStart = windowEnd = offset;
+            eof = false;
+            error = 0;
+            writable.wakeOne();
+        }
+        readPos = offset;
+        return offset;
+    }
+
+    void readLoop()
+    {
+        std::vector<uint8_t> block(s_blockSize);
+        // offset of innerContext, it is only seeked when the ring does not continue there
+        qint64 innerPos = 0;
+        QMutexLocker locker(&mutex);
+        while (!stopped) {
+            auto free = capacity - (windowEnd - windowStart);
+            auto evictable = qMax<qint64>(readPos - backReserve() - windowStart, 0);
+            if (eof || error != 0 || (free == 0 && evictable == 0)) {
+                writable.wait(&mutex);
+                continue;
+            }
+            auto currentGeneration = generation;
+            auto position = windowEnd;
+            auto size = static_cast<int>(qMin<qint64>(s_blockSize, free + evictable));
+            locker.unlock();
+
+            int ret = 0;
+            if (innerPos != position) {
+                auto seeked = avio_seek(innerContext, position, SEEK_SET);
+                ret = seeked < 0 ? static_cast<int>(seeked) : 0;
+                innerPos = seeked < 0 ? -1 : position;
+            }
+            if (ret >= 0) {
+                ret = avio_read_partial(innerContext, block.data(), size);
+                innerPos = ret > 0 ? innerPos + ret : -1;
+            }
+
+            locker.relock();
+            if (generation != currentGeneration) {
+                // the demuxer seeked elsewhere meanwhile, this block is stale
+                continue;
+            }
+            if (ret == AVERROR_EOF || ret == 0) {
+                eof = true;
+            } else if (ret < 0) {
+                SET_ERROR_CODE(ret);
+                error = ret;
+            } else {
+                auto overflow = (windowEnd - windowStart) + ret - capacity;
+                if (overflow > 0 && windowStart + overflow > readPos) {
+                    // a short backward seek made the evicted part needed again, read it later
+                    continue;
+                }
+                if (overflow > 0) {
+                    windowStart += overflow;
+                }
+                auto index = windowEnd % capacity;
+                auto first = static_cast<int>(qMin<qint64>(ret, capacity - index));
+                memcpy(ring.data() + index, block.data(), first);
+                memcpy(ring.data(), block.data() + first, ret - first);
+                windowEnd += ret;
+            }
+            readable.wakeAll();
+        }
+    }
+
+    PrefetchIO *q_ptr;
+
+    qint64 capacity = 0;
+    std::vector<uint8_t> ring;
+
+    AVIOContext *innerContext = nullptr;
+    AVIOContext *avioContext = nullptr;
+    QScopedPointer<QThread> thread;
+    qint64 fileSize = -1;
+
+    QMutex mutex;
+    QWaitCondition readable;
+    QWaitCondition writable;
+    // file offsets, [windowStart, windowEnd) is in the ring
+    qint64 windowStart = 0;
+    qint64 windowEnd = 0;
+    qint64 readPos = 0;
+    // bumped by every seek out of the ring
+    quint64 generation = 0;
+    bool eof = false;
+    int error = 0;
+    bool stopped = false;
+};
+
+PrefetchIO::PrefetchIO(qint64 bufferSize)
+    : d_ptr(new PrefetchIOPrivate(this))
+{
+    d_ptr->capacity = qMax<qint64>(bufferSize, s_blockSize * 4);
+}
+
+PrefetchIO::~PrefetchIO()
+{
+    close();
+}
+
+auto PrefetchIO::open(const QByteArray &url) -> bool
+{
+    close();
+    auto ret = avio_open2(&d_ptr->innerContext, url.constData(), AVIO_FLAG_READ, nullptr, nullptr);
+    if (ret < 0) {
+        SET_ERROR_CODE(ret);
+        return false;
+    }
+    d_ptr->fileSize = avio_size(d_ptr->innerContext);
+    d_ptr->ring.resize(d_ptr->capacity);
+    d_ptr->windowStart = d_ptr->windowEnd = d_ptr->readPos = 0;
+    d_ptr->generation = 0;
+    d_ptr->eof = false;
+    d_ptr->error = 0;
+    d_ptr->stopped = false;
+
+    auto *buffer = static_cast<uint8_t *>(av_malloc(s_ioBufferSize));
+    d_ptr->avioContext = avio_alloc_context(buffer,
+                                            s_ioBufferSize,
+                                            0,
+                                            d_ptr.data(),
+                                            &PrefetchIOPrivate::readPacket,
+                                            nullptr,
+                                            &PrefetchIOPrivate::seekPacket);
+    d_ptr->avioContext->seekable = d_ptr->innerContext->seekable;
+
+    d_ptr->thread.reset(QThread::create([this] { d_ptr->readLoop(); }));
+    d_ptr->thread->setObjectName("PrefetchIO");
+    d_ptr->thread->start();
+    return true;
+}
+
+void PrefetchIO::close()
+{
+    if (!d_ptr->thread.isNull()) {
+        {
+            QMutexLocker locker(&d_ptr->mutex);
+            d_ptr->stopped = true;
+            d_ptr->writable.wakeAll();
+            d_ptr->readable.wakeAll();
+        }
+        d_ptr->thread->wait();
+        d_ptr->thread.reset();
+    }
+    if (d_ptr->avioContext != nullptr) {
+        av_freep(&d_ptr->avioContext->buffer);
+        avio_context_free(&d_ptr->avioContext);
+    }
+    if (d_ptr->innerContext != nullptr) {
+        avio_closep(&d_ptr->innerContext);
+    }
+    d_ptr->ring.clear();
+    d_ptr->ring.shrink_to_fit();
+}
+
+auto PrefetchIO::avioContext() -> AVIOContext *
+{
+    return d_ptr->avioContext;
+}
+
+auto PrefetchIO::bufferSize() const -> qint64
+{
+    return d_ptr->capacity;
+}
+
+auto PrefetchIO::bufferedBytes() const -> qint64
+{
+    QMutexLocker locker(&d_ptr->mutex);
+    return d_ptr->windowEnd - d_ptr->readPos;
+}
+
+} // namespace Ffmpeg
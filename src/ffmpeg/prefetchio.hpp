@@ -0,0 +1,39 @@
+#ifndef PREFETCHIO_HPP
+#define PREFETCHIO_HPP
+
+#include <QtCore>
+
+struct AVIOContext;
+
+namespace Ffmpeg {
+
+// Custom AVIOContext that reads ahead of the demuxer on its own thread.
+// Data is kept in a ring of bufferSize bytes that also holds a part already read, so a seek
+// inside the ring costs no I/O, a seek outside of it restarts the read-ahead there. Disk and
+// network stalls are absorbed by the ring instead of blocking av_read_frame.
+class PrefetchIO
+{
+    Q_DISABLE_COPY_MOVE(PrefetchIO)
+public:
+    explicit PrefetchIO(qint64 bufferSize);
+    ~PrefetchIO();
+
+    // opens url with the ffmpeg protocols and starts reading ahead
+    auto open(const QByteArray &url) -> bool;
+    void close();
+
+    // for AVFormatContext::pb with AVFMT_FLAG_CUSTOM_IO, owned by this
+    auto avioContext() -> AVIOContext *;
+
+    [[nodiscard]] auto bufferSize() const -> qint64;
+    // bytes read ahead of the demuxer
+    [[nodiscard]] auto bufferedBytes() const -> qint64;
+
+private:
+    class PrefetchIOPrivate;
+    QScopedPointer<PrefetchIOPrivate> d_ptr;
+};
+
+} // namespace Ffmpeg
+
+#endif // PREFETCHIO_HPP
@@ -0,0 +1,135 @@
+#include "presentationscheduler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <ctime>
+#endif
+
+extern "C" {
+#include <libavutil/avutil.h>
+#include <libavutil/time.h>
+}
+
+namespace Ffmpeg {
+
+// the last part of a wait is spent spinning, sleeps overshoot by about this much
+#ifdef Q_OS_WIN
+static constexpr auto s_spinThreshold = 2000; // microseconds
+#else
+static constexpr auto s_spinThreshold = 300; // microseconds
+#endif
+// without a known refresh interval, later than this counts as a late frame
+static constexpr auto s_lateThreshold = 4000; // microseconds
+
+class PresentationScheduler::PresentationSchedulerPrivate
+{
+public:
+    explicit PresentationSchedulerPrivate(PresentationScheduler *q)
+        : q_ptr(q)
+    {}
+
+    PresentationScheduler *q_ptr;
+
+    std::atomic<qint64> refreshInterval = 0;
+    // a refresh boundary on the grid, 0 if none yet, display thread only
+    qint64 gridAnchor = 0;
+
+    std::atomic<qint64> lateness = 0;
+    std::atomic<qint64> averageLateness = 0;
+    std::atomic<quint64> lateCount = 0;
+};
+
+PresentationScheduler::PresentationScheduler(QObject *parent)
+    : QObject{parent}
+    , d_ptr(new PresentationSchedulerPrivate(this))
+{}
+
+PresentationScheduler::~PresentationScheduler() = default;
+
+void PresentationScheduler::setRefreshInterval(qint64 interval)
+{
+    d_ptr->refreshInterval.store(qMax(interval, qint64(0)));
+}
+
+auto PresentationScheduler::refreshInterval() const -> qint64
+{
+    return d_ptr->refreshInterval.load();
+}
+
+void PresentationScheduler::reset()
+{
+    d_ptr->gridAnchor = 0;
+    d_ptr->lateness.store(0);
+    d_ptr->averageLateness.store(0);
+}
+
+auto PresentationScheduler::target(qint64 time) -> qint64
+{
+    auto interval = d_ptr->refreshInterval.load();
+    if (interval <= 0) {
+        return time;
+    }
+    if (d_ptr->gridAnchor == 0 || time < d_ptr->gridAnchor) {
+        d_ptr->gridAnchor = time;
+        return time;
+    }
+    // nearest boundary, a frame due half way between two refreshes keeps its side
+    auto ticks = (time - d_ptr->gridAnchor + interval / 2) / interval;
+    return d_ptr->gridAnchor + ticks * interval;
+}
+
+void PresentationScheduler::presented(qint64 target, qint64 time)
+{
+    auto lateness = time - target;
+    d_ptr->lateness.store(lateness);
+    auto average = d_ptr->averageLateness.load();
+    d_ptr->averageLateness.store(average + (lateness - average) / 8);
+
+    auto interval = d_ptr->refreshInterval.load();
+    if (lateness > (interval > 0 ? interval : s_lateThreshold)) {
+        d_ptr->lateCount.fetch_add(1);
+        // the grid no longer matches what was shown, start a new one at the next frame
+        d_ptr->gridAnchor = 0;
+    }
+}
+
+auto PresentationScheduler::lateness() const -> qint64
+{
+    return d_ptr->lateness.load();
+}
+
+auto PresentationScheduler::averageLateness() const -> qint64
+{
+    return d_ptr->averageLateness.load();
+}
+
+auto PresentationScheduler::lateCount() const -> quint64
+{
+    return d_ptr->lateCount.load();
+}
+
+void PresentationScheduler::sleepUntil(qint64 time)
+{
+    auto wakeupTime = time - s_spinThreshold;
+    auto now = av_gettime_relative();
+    if (now < wakeupTime) {
+#ifdef Q_OS_LINUX
+        // av_gettime_relative() is CLOCK_MONOTONIC here, so the deadline can be absolute and a
+        // preemption before the call does not stretch the wait
+        timespec ts{static_cast<time_t>(wakeupTime / AV_TIME_BASE),
+                    static_cast<long>(wakeupTime % AV_TIME_BASE * 1000)};
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+        }
+#else
+        std::this_thread::sleep_for(std::chrono::microseconds(wakeupTime - now));
+#endif
+    }
+    while (av_gettime_relative() < time) {
+    }
+}
+
+} // namespace Ffmpeg
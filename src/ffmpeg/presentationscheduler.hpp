@@ -0,0 +1,49 @@
+#ifndef PRESENTATIONSCHEDULER_HPP
+#define PRESENTATIONSCHEDULER_HPP
+
+#include <QObject>
+
+namespace Ffmpeg {
+
+// Presents video frames at absolute av_gettime_relative() deadlines with sub-millisecond
+// precision: an absolute sleep that ends a little early, then a spin for the rest.
+// When the refresh interval of the display is known, deadlines are snapped to a grid of that
+// interval, so clock jitter can no longer move a frame across a refresh boundary. That flip is
+// what makes 50/60 Hz content judder on 60/120 Hz panels.
+class PresentationScheduler : public QObject
+{
+public:
+    explicit PresentationScheduler(QObject *parent = nullptr);
+    ~PresentationScheduler() override;
+
+    // microseconds, <= 0 if unknown, thread safe
+    void setRefreshInterval(qint64 interval);
+    [[nodiscard]] auto refreshInterval() const -> qint64;
+
+    // drops the refresh grid and the lateness history, after a seek or a pause
+    void reset();
+
+    // the deadline to present a frame due at time
+    auto target(qint64 time) -> qint64;
+
+    // record that the frame targeted at target was presented at time
+    void presented(qint64 target, qint64 time);
+
+    // microseconds, how late frames are presented, thread safe
+    [[nodiscard]] auto lateness() const -> qint64;
+    [[nodiscard]] auto averageLateness() const -> qint64;
+    // frames presented later than a refresh interval
+    [[nodiscard]] auto lateCount() const -> quint64;
+
+    // blocks the calling thread until time, av_gettime_relative() based, microseconds.
+    // Only for a dedicated thread, the last part of the wait is a spin.
+    static void sleepUntil(qint64 time);
+
+private:
+    class PresentationSchedulerPrivate;
+    QScopedPointer<PresentationSchedulerPrivate> d_ptr;
+};
+
+} // namespace Ffmpeg
+
+#endif // PRESENTATIONSCHEDULER_HPP
@@ -4,6 +4,7 @@
 #include "codeccontext.h"
 #include "formatcontext.h"
 #include "frame.hpp"
+#include "imagebufferpool.hpp"
 #include "packet.h"
 #include "transcoder.hpp"
 #include "videoframeconverter.hpp"
@@ -16,6 +17,14 @@ extern "C" {
 
 namespace Ffmpeg {
 
+// shared by all preview tasks, previews of one widget mostly have the same size,
+// created on first use instead of during static initialization
+static auto previewBufferPool() -> ImageBufferPool *
+{
+    static ImageBufferPool pool;
+    return &pool;
+}
+
 static auto getKeyFrame(FormatContext *formatContext,
                         AVContextInfo *videoInfo,
                         qint64 timestamp,
@@ -76,8 +85,8 @@ public:
             auto dst_pix_fmt = AV_PIX_FMT_RGB32;
             QScopedPointer<VideoFrameConverter> frameConverterPtr(
                 new VideoFrameConverter(framePtr.data(), dstSize, dst_pix_fmt));
-            QSharedPointer<Frame> frameRgbPtr(new Frame);
-            frameRgbPtr->imageAlloc(dstSize, dst_pix_fmt);
+            FramePtr frameRgbPtr(new Frame);
+            previewBufferPool()->imageAlloc(frameRgbPtr.data(), dstSize, dst_pix_fmt);
             //frameConverterPtr->flush(framePtr.data(), dstSize);
             frameConverterPtr->scale(framePtr.data(), frameRgbPtr.data());
             auto image = frameRgbPtr->toImage();
@@ -113,6 +122,8 @@ public:
     qint64 timestamp;
     int taskId = 0;
     QPointer<VideoPreviewWidget> videoPreviewWidgetPtr;
+    ThreadingPolicy threadingPolicy = ThreadingPolicy::preview();
+    qint64 prefetchSize = 0;
     std::atomic_bool runing = true;
 };
 
@@ -137,9 +148,20 @@ PreviewOneTask::~PreviewOneTask()
     d_ptr->runing.store(false);
 }
 
+void PreviewOneTask::setThreadingPolicy(const ThreadingPolicy &threadingPolicy)
+{
+    d_ptr->threadingPolicy = threadingPolicy;
+}
+
+void PreviewOneTask::setPrefetchSize(qint64 bytes)
+{
+    d_ptr->prefetchSize = bytes;
+}
+
 void PreviewOneTask::run()
 {
     QScopedPointer<FormatContext> formatCtxPtr(new FormatContext);
+    formatCtxPtr->setPrefetchSize(d_ptr->prefetchSize);
     if (!formatCtxPtr->openFilePath(d_ptr->filepath) || !formatCtxPtr->findStream()) {
         return;
     }
@@ -147,7 +169,8 @@ void PreviewOneTask::run()
     QScopedPointer<AVContextInfo> videoInfoPtr(new AVContextInfo);
     videoInfoPtr->setIndex(d_ptr->videoIndex);
     videoInfoPtr->setStream(formatCtxPtr->stream(d_ptr->videoIndex));
-    if (!videoInfoPtr->initDecoder(formatCtxPtr->guessFrameRate(d_ptr->videoIndex))) {
+    if (!videoInfoPtr->initDecoder(formatCtxPtr->guessFrameRate(d_ptr->videoIndex),
+                                   d_ptr->threadingPolicy)) {
         return;
     }
     videoInfoPtr->openCodec(); // 软解
@@ -201,6 +224,8 @@ public:
     QString filepath;
     int count;
     QPointer<Transcoder> transcoderPtr;
+    ThreadingPolicy threadingPolicy = ThreadingPolicy::preview();
+    qint64 prefetchSize = 0;
     std::atomic_bool runing = true;
 };
 
@@ -219,9 +244,20 @@ PreviewCountTask::~PreviewCountTask()
     d_ptr->runing.store(false);
 }
 
+void PreviewCountTask::setThreadingPolicy(const ThreadingPolicy &threadingPolicy)
+{
+    d_ptr->threadingPolicy = threadingPolicy;
+}
+
+void PreviewCountTask::setPrefetchSize(qint64 bytes)
+{
+    d_ptr->prefetchSize = bytes;
+}
+
 void PreviewCountTask::run()
 {
     QScopedPointer<FormatContext> formatCtxPtr(new FormatContext);
+    formatCtxPtr->setPrefetchSize(d_ptr->prefetchSize);
     if (!formatCtxPtr->openFilePath(d_ptr->filepath) || !formatCtxPtr->findStream()) {
         return;
     }
@@ -234,7 +270,8 @@ void PreviewCountTask::run()
     QScopedPointer<AVContextInfo> videoInfoPtr(new AVContextInfo);
     videoInfoPtr->setIndex(videoIndex);
     videoInfoPtr->setStream(formatCtxPtr->stream(videoIndex));
-    if (!videoInfoPtr->initDecoder(formatCtxPtr->guessFrameRate(videoIndex))) {
+    if (!videoInfoPtr->initDecoder(formatCtxPtr->guessFrameRate(videoIndex),
+                                   d_ptr->threadingPolicy)) {
         return;
     }
     videoInfoPtr->openCodec(AVContextInfo::GpuDecode);
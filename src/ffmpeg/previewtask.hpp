@@ -1,6 +1,8 @@
 #ifndef PREVIEWTASK_HPP
 #define PREVIEWTASK_HPP
 
+#include "threadingpolicy.hpp"
+
 #include <QRunnable>
 #include <QtCore>
 
@@ -17,6 +19,11 @@ public:
                             VideoPreviewWidget *videoPreviewWidget);
     ~PreviewOneTask() override;
 
+    // before the task is started, ThreadingPolicy::preview() by default
+    void setThreadingPolicy(const ThreadingPolicy &threadingPolicy);
+    // before the task is started, bytes read ahead on an I/O thread, 0 by default
+    void setPrefetchSize(qint64 bytes);
+
     void run() override;
 
 private:
@@ -31,6 +38,11 @@ public:
     explicit PreviewCountTask(const QString &filepath, int count, Transcoder *transcoder);
     ~PreviewCountTask() override;
 
+    // before the task is started, ThreadingPolicy::preview() by default
+    void setThreadingPolicy(const ThreadingPolicy &threadingPolicy);
+    // before the task is started, bytes read ahead on an I/O thread, 0 by default
+    void setPrefetchSize(qint64 bytes);
+
     void run() override;
 
 private:
@@ -14,22 +14,24 @@ namespace Ffmpeg {
 class SubtitleDecoder::SubtitleDecoderPrivate
 {
 public:
-    explicit SubtitleDecoderPrivate(SubtitleDecoder *q)
+    explicit SubtitleDecoderPrivate(ClockDomain *clockDomain, SubtitleDecoder *q)
         : q_ptr(q)
     {
-        decoderSubtitleFrame = new SubtitleDisplay(q_ptr);
+        decoderSubtitleFrame = new SubtitleDisplay(clockDomain, q_ptr);
     }
 
-    void processEvent() const
+    void processEvent()
     {
         while (q_ptr->m_runing.load() && !q_ptr->m_eventQueue.empty()) {
             auto eventPtr = q_ptr->m_eventQueue.take();
             switch (eventPtr->type()) {
-            case Event::EventType::Pause: decoderSubtitleFrame->addEvent(eventPtr); break;
+            case Event::EventType::Pause:
+            case Event::EventType::Buffering: decoderSubtitleFrame->addEvent(eventPtr); break;
             case Event::EventType::Seek: {
                 auto *seekEvent = static_cast<SeekEvent *>(eventPtr.data());
                 seekEvent->countDown();
                 q_ptr->clear();
+                subtitlePtr.reset();
                 decoderSubtitleFrame->addEvent(eventPtr);
             } break;
             default: break;
@@ -40,12 +42,16 @@ public:
     SubtitleDecoder *q_ptr;
 
     SubtitleDisplay *decoderSubtitleFrame;
+    // decoded subtitle the display queue could not take yet
+    SubtitlePtr subtitlePtr;
 };
 
-SubtitleDecoder::SubtitleDecoder(QObject *parent)
+SubtitleDecoder::SubtitleDecoder(ClockDomain *clockDomain, QObject *parent)
     : Decoder<PacketPtr>(parent)
-    , d_ptr(new SubtitleDecoderPrivate(this))
-{}
+    , d_ptr(new SubtitleDecoderPrivate(clockDomain, this))
+{
+    d_ptr->decoderSubtitleFrame->setUpstream([this] { notify(); });
+}
 
 SubtitleDecoder::~SubtitleDecoder()
 {
@@ -62,34 +68,54 @@ void SubtitleDecoder::setVideoRenders(const QVector<VideoRender *> &videoRenders
     d_ptr->decoderSubtitleFrame->setVideoRenders(videoRenders);
 }
 
-void SubtitleDecoder::runDecoder()
+void SubtitleDecoder::onDecoderStarted()
 {
+    d_ptr->decoderSubtitleFrame->setUseSharedExecutor(useSharedExecutor());
+    d_ptr->decoderSubtitleFrame->setLowLatency(lowLatency());
     d_ptr->decoderSubtitleFrame->startDecoder(m_formatContext, m_contextInfo);
+}
 
-    while (m_runing) {
-        d_ptr->processEvent();
+void SubtitleDecoder::onDecoderStopped()
+{
+    d_ptr->subtitlePtr.reset();
+    d_ptr->decoderSubtitleFrame->stopDecoder();
+}
 
-        auto packetPtr(m_queue.take());
-        if (packetPtr.isNull()) {
-            continue;
-        }
-        //qDebug() << "packet ass :" << QString::fromUtf8(packetPtr->avPacket()->data);
-        SubtitlePtr subtitlePtr(new Subtitle);
-        if (!m_contextInfo->decodeSubtitle2(subtitlePtr, packetPtr)) {
-            continue;
+auto SubtitleDecoder::runDecoderStep() -> bool
+{
+    d_ptr->processEvent();
+    if (!d_ptr->subtitlePtr.isNull()) {
+        if (!d_ptr->decoderSubtitleFrame->tryAppend(std::move(d_ptr->subtitlePtr))) {
+            return false;
         }
+        d_ptr->subtitlePtr.reset();
+    }
 
-        calculatePts(packetPtr.data(), m_contextInfo);
-        subtitlePtr->setDefault(packetPtr->pts(),
-                                packetPtr->duration(),
-                                reinterpret_cast<const char *>(packetPtr->avPacket()->data));
-
-        d_ptr->decoderSubtitleFrame->append(subtitlePtr);
+    PacketPtr packetPtr;
+    if (!m_queue.tryTake(packetPtr)) {
+        return false;
     }
-    while (m_runing && d_ptr->decoderSubtitleFrame->size() != 0) {
-        msleep(s_waitQueueEmptyMilliseconds);
+    if (packetPtr.isNull()) {
+        return true;
     }
-    d_ptr->decoderSubtitleFrame->stopDecoder();
+    //qDebug() << "packet ass :" << QString::fromUtf8(packetPtr->avPacket()->data);
+    SubtitlePtr subtitlePtr(new Subtitle);
+    if (!m_contextInfo->decodeSubtitle2(subtitlePtr, packetPtr)) {
+        return true;
+    }
+
+    // the packet may also sit in the player's packet cache and be replayed after a seek, its
+    // timestamps stay in stream time base
+    auto *avPacket = packetPtr->avPacket();
+    auto timeBase = m_contextInfo->timebase();
+    subtitlePtr->setDefault(rescaleToMicroseconds(avPacket->pts, timeBase),
+                            rescaleToMicroseconds(avPacket->duration, timeBase),
+                            reinterpret_cast<const char *>(avPacket->data));
+
+    if (!d_ptr->decoderSubtitleFrame->tryAppend(std::move(subtitlePtr))) {
+        d_ptr->subtitlePtr = subtitlePtr;
+    }
+    return true;
 }
 
 } // namespace Ffmpeg
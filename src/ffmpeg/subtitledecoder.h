@@ -6,12 +6,13 @@
 
 namespace Ffmpeg {
 
+class ClockDomain;
 class VideoRender;
 
 class SubtitleDecoder : public Decoder<PacketPtr>
 {
 public:
-    explicit SubtitleDecoder(QObject *parent = nullptr);
+    explicit SubtitleDecoder(ClockDomain *clockDomain, QObject *parent = nullptr);
     ~SubtitleDecoder() override;
 
     void setVideoResolutionRatio(const QSize &size);
@@ -19,7 +20,9 @@ public:
     void setVideoRenders(const QVector<VideoRender *> &videoRenders);
 
 protected:
-    void runDecoder() override;
+    void onDecoderStarted() override;
+    void onDecoderStopped() override;
+    auto runDecoderStep() -> bool override;
 
 private:
     class SubtitleDecoderPrivate;
@@ -9,7 +9,6 @@
 
 #include <QDebug>
 #include <QImage>
-#include <QWaitCondition>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -22,10 +21,10 @@ namespace Ffmpeg {
 class SubtitleDisplay::SubtitleDisplayPrivate
 {
 public:
-    explicit SubtitleDisplayPrivate(SubtitleDisplay *q)
+    explicit SubtitleDisplayPrivate(ClockDomain *clockDomain, SubtitleDisplay *q)
         : q_ptr(q)
     {
-        clock = new Clock(q);
+        clock = new Clock(clockDomain, q);
     }
 
     void renderFrame(const QSharedPointer<Subtitle> &subtitlePtr)
@@ -36,7 +35,7 @@ public:
         }
     }
 
-    void processEvent(Ass *ass, bool &firstFrame) const
+    void processEvent()
     {
         while (q_ptr->m_runing.load() && !q_ptr->m_eventQueue.empty()) {
             qDebug() << "DecoderSubtitleFrame::processEvent";
@@ -47,9 +46,14 @@ public:
                 auto paused = pauseEvent->paused();
                 clock->setPaused(paused);
             } break;
+            case Event::EventType::Buffering: {
+                auto *bufferingEvent = static_cast<BufferingEvent *>(eventPtr.data());
+                clock->setPaused(bufferingEvent->buffering());
+            } break;
             case Event::EventType::Seek: {
                 q_ptr->clear();
-                ass->flushASSEvents();
+                assPtr->flushASSEvents();
+                subtitlePtr.reset();
                 firstFrame = false;
             }
             default: break;
@@ -61,17 +65,23 @@ public:
 
     Clock *clock;
 
-    QMutex mutex;
-    QWaitCondition waitCondition;
+    QScopedPointer<Ass> assPtr;
+    SwsContext *swsContext = nullptr;
+    bool firstFrame = false;
+    quint64 dropNum = 0;
+    // subtitle waiting for its render time
+    SubtitlePtr subtitlePtr;
+    qint64 renderTime = 0;
+
     QSize videoResolutionRatio = QSize(1280, 720);
 
     QMutex mutex_render;
     QVector<VideoRender *> videoRenders = {};
 };
 
-SubtitleDisplay::SubtitleDisplay(QObject *parent)
+SubtitleDisplay::SubtitleDisplay(ClockDomain *clockDomain, QObject *parent)
     : Decoder<SubtitlePtr>(parent)
-    , d_ptr(new SubtitleDisplayPrivate(this))
+    , d_ptr(new SubtitleDisplayPrivate(clockDomain, this))
 {}
 
 SubtitleDisplay::~SubtitleDisplay()
@@ -93,58 +103,78 @@ void SubtitleDisplay::setVideoRenders(const QVector<VideoRender *> &videoRenders
     d_ptr->videoRenders = videoRenders;
 }
 
-void SubtitleDisplay::runDecoder()
+void SubtitleDisplay::onDecoderStarted()
 {
-    quint64 dropNum = 0;
     auto *ctx = m_contextInfo->codecCtx()->avCodecCtx();
-    QScopedPointer<Ass> assPtr(new Ass);
+    d_ptr->assPtr.reset(new Ass);
     if (ctx->subtitle_header != nullptr) {
-        assPtr->init(ctx->subtitle_header, ctx->subtitle_header_size);
+        d_ptr->assPtr->init(ctx->subtitle_header, ctx->subtitle_header_size);
     }
-    assPtr->setWindowSize(d_ptr->videoResolutionRatio);
-    SwsContext *swsContext = nullptr;
-    bool firstFrame = false;
-    while (m_runing.load()) {
-        d_ptr->processEvent(assPtr.data(), firstFrame);
+    d_ptr->assPtr->setWindowSize(d_ptr->videoResolutionRatio);
+    d_ptr->dropNum = 0;
+    d_ptr->firstFrame = false;
+    d_ptr->subtitlePtr.reset();
+}
 
-        auto subtitlePtr(m_queue.take());
+void SubtitleDisplay::onDecoderStopped()
+{
+    d_ptr->subtitlePtr.reset();
+    sws_freeContext(d_ptr->swsContext);
+    d_ptr->swsContext = nullptr;
+    d_ptr->assPtr.reset();
+    qInfo() << "Subtitle Drop Num:" << d_ptr->dropNum;
+}
+
+auto SubtitleDisplay::runDecoderStep() -> bool
+{
+    d_ptr->processEvent();
+
+    if (d_ptr->subtitlePtr.isNull()) {
+        SubtitlePtr subtitlePtr;
+        if (!m_queue.tryTake(subtitlePtr)) {
+            return false;
+        }
         if (subtitlePtr.isNull()) {
-            continue;
+            return true;
         }
-        if (!firstFrame) {
+        if (!d_ptr->firstFrame) {
             qDebug() << "Subtitle firstFrame: "
                      << QTime::fromMSecsSinceStartOfDay(subtitlePtr->pts() / 1000)
                             .toString("hh:mm:ss.zzz");
-            firstFrame = true;
+            d_ptr->firstFrame = true;
             d_ptr->clock->reset(subtitlePtr->pts());
         }
         subtitlePtr->setVideoResolutionRatio(d_ptr->videoResolutionRatio);
-        subtitlePtr->parse(&swsContext);
+        subtitlePtr->parse(&d_ptr->swsContext);
         if (subtitlePtr->type() == Subtitle::Type::ASS) {
-            subtitlePtr->resolveAss(assPtr.data());
+            subtitlePtr->resolveAss(d_ptr->assPtr.data());
             subtitlePtr->generateImage();
         }
         d_ptr->clock->update(subtitlePtr->pts(), av_gettime_relative());
         qint64 delay = 0;
         if (!d_ptr->clock->getDelayWithMaster(delay)) {
-            continue;
+            return true;
         }
         auto delayDuration = delay + subtitlePtr->duration();
         if (!d_ptr->clock->adjustDelay(delayDuration)) {
             qDebug() << "Subtitle Delay: " << delay;
-            dropNum++;
-            continue;
+            d_ptr->dropNum++;
+            return true;
         }
-        if (d_ptr->clock->adjustDelay(delay)) {
-            if (delay > 0) {
-                QMutexLocker locker(&d_ptr->mutex);
-                d_ptr->waitCondition.wait(&d_ptr->mutex, delay / 1000);
-            }
+        if (!d_ptr->clock->adjustDelay(delay)) {
+            delay = 0;
         }
-        d_ptr->renderFrame(subtitlePtr);
+        d_ptr->subtitlePtr = subtitlePtr;
+        d_ptr->renderTime = av_gettime_relative() + delay;
+    }
+
+    if (av_gettime_relative() < d_ptr->renderTime) {
+        wakeupAt(d_ptr->renderTime);
+        return false;
     }
-    sws_freeContext(swsContext);
-    qInfo() << "Subtitle Drop Num:" << dropNum;
+    d_ptr->renderFrame(d_ptr->subtitlePtr);
+    d_ptr->subtitlePtr.reset();
+    return true;
 }
 
 } // namespace Ffmpeg
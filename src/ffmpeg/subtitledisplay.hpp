@@ -6,13 +6,14 @@
 
 namespace Ffmpeg {
 
+class ClockDomain;
 class VideoRender;
 class Ass;
 
 class SubtitleDisplay : public Decoder<SubtitlePtr>
 {
 public:
-    explicit SubtitleDisplay(QObject *parent = nullptr);
+    explicit SubtitleDisplay(ClockDomain *clockDomain, QObject *parent = nullptr);
     ~SubtitleDisplay() override;
 
     void setVideoResolutionRatio(const QSize &size);
@@ -20,7 +21,9 @@ public:
     void setVideoRenders(const QVector<VideoRender *> &videoRenders);
 
 protected:
-    void runDecoder() override;
+    void onDecoderStarted() override;
+    void onDecoderStopped() override;
+    auto runDecoderStep() -> bool override;
 
 private:
     class SubtitleDisplayPrivate;
@@ -0,0 +1,85 @@
+#include "threadingpolicy.hpp"
+
+#include <QThread>
+
+#include <cmath>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+namespace Ffmpeg {
+
+auto ThreadingPolicy::playback() -> ThreadingPolicy
+{
+    return {};
+}
+
+auto ThreadingPolicy::transcode() -> ThreadingPolicy
+{
+    ThreadingPolicy policy;
+    policy.fixedThreadCount = QThread::idealThreadCount();
+    return policy;
+}
+
+auto ThreadingPolicy::preview() -> ThreadingPolicy
+{
+    ThreadingPolicy policy;
+    policy.mode = Mode::Slice;
+    policy.maxThreadCount = 2;
+    return policy;
+}
+
+auto ThreadingPolicy::live() -> ThreadingPolicy
+{
+    ThreadingPolicy policy;
+    policy.mode = Mode::LowLatency;
+    return policy;
+}
+
+auto ThreadingPolicy::threadCount(const AVCodecContext *codecCtx) const -> int
+{
+    if (fixedThreadCount > 0) {
+        return fixedThreadCount;
+    }
+    auto cores = qMax(QThread::idealThreadCount(), 1);
+    auto limit = maxThreadCount > 0 ? qMin(maxThreadCount, cores) : cores;
+    if (codecCtx->codec_type != AVMEDIA_TYPE_VIDEO) {
+        return 1;
+    }
+    if (codecCtx->width <= 0 || codecCtx->height <= 0) {
+        return limit;
+    }
+    auto fps = codecCtx->framerate.num > 0 && codecCtx->framerate.den > 0
+                   ? av_q2d(codecCtx->framerate)
+                   : 30.0;
+    auto pixelRate = static_cast<double>(codecCtx->width) * codecCtx->height * fps;
+    auto count = static_cast<int>(std::ceil(pixelRate / s_pixelRatePerThread));
+    return qBound(1, count, limit);
+}
+
+void ThreadingPolicy::apply(AVCodecContext *codecCtx) const
+{
+    int threadType = 0;
+    auto capabilities = codecCtx->codec != nullptr ? codecCtx->codec->capabilities : 0;
+    auto frame = (capabilities & AV_CODEC_CAP_FRAME_THREADS) != 0;
+    auto slice = (capabilities & AV_CODEC_CAP_SLICE_THREADS) != 0;
+    switch (mode) {
+    case Mode::Auto: threadType = FF_THREAD_FRAME | FF_THREAD_SLICE; break;
+    case Mode::Frame: threadType = frame ? FF_THREAD_FRAME : FF_THREAD_SLICE; break;
+    case Mode::Slice: threadType = FF_THREAD_SLICE; break;
+    case Mode::LowLatency:
+        threadType = FF_THREAD_SLICE;
+        codecCtx->flags |= AV_CODEC_FLAG_LOW_DELAY;
+        break;
+    }
+    auto count = threadCount(codecCtx);
+    // threads the codec cannot use would only be created and left idle
+    if (threadType == FF_THREAD_SLICE && !slice) {
+        count = 1;
+    }
+    codecCtx->thread_type = threadType;
+    codecCtx->thread_count = count;
+}
+
+} // namespace Ffmpeg
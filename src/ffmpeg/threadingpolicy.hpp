@@ -0,0 +1,48 @@
+#ifndef THREADINGPOLICY_HPP
+#define THREADINGPOLICY_HPP
+
+#include "ffmepg_global.h"
+
+struct AVCodecContext;
+
+namespace Ffmpeg {
+
+// How a decoder spreads its work over threads.
+// Frame threading scales best but delays output by one frame per thread, slice threading adds no
+// delay but only helps streams encoded with several slices.
+struct FFMPEG_EXPORT ThreadingPolicy
+{
+    enum class Mode : int {
+        Auto,      // whatever the codec supports, ffmpeg prefers frame threading
+        Frame,     // frame threading, falls back to slices if the codec lacks it
+        Slice,     // slice threading only
+        LowLatency // slice threading and AV_CODEC_FLAG_LOW_DELAY, for live and interactive use
+    };
+
+    // pixels per second one decoder thread is given
+    static constexpr auto s_pixelRatePerThread = 1280LL * 720 * 30;
+
+    // playback of one stream, enough threads for the pixel rate
+    static auto playback() -> ThreadingPolicy;
+    // throughput first, every core
+    static auto transcode() -> ThreadingPolicy;
+    // single frames, no frame threading latency and memory
+    static auto preview() -> ThreadingPolicy;
+    // live inputs, every frame out as soon as it is decoded
+    static auto live() -> ThreadingPolicy;
+
+    // the thread count for the opened parameters of codecCtx, width, height and framerate
+    [[nodiscard]] auto threadCount(const AVCodecContext *codecCtx) const -> int;
+    // set thread_type and thread_count, before avcodec_open2
+    void apply(AVCodecContext *codecCtx) const;
+
+    Mode mode = Mode::Auto;
+    // > 0 is used as is, otherwise derived from the cores and the pixel rate
+    int fixedThreadCount = 0;
+    // upper limit of a derived count, <= 0 for the number of cores
+    int maxThreadCount = 16;
+};
+
+} // namespace Ffmpeg
+
+#endif // THREADINGPOLICY_HPP
@@ -116,6 +116,7 @@ public:
     auto openInputFile(bool eventChanged) -> bool
     {
         Q_ASSERT(!inFilePath.isEmpty());
+        inFormatContext->setPrefetchSize(prefetchSize);
         auto ret = inFormatContext->openFilePath(inFilePath);
         if (!ret) {
             return ret;
@@ -374,9 +375,9 @@ public:
         if (flush) {
             FramePtr frame_tmp_ptr(new Frame);
             frame_tmp_ptr->destroyFrame();
-            packetPtrs = transcodeCtx->encContextInfoPtr->encodeFrame(frame_tmp_ptr);
+            transcodeCtx->encContextInfoPtr->encodeFrame(frame_tmp_ptr, packetPtrs);
         } else {
-            packetPtrs = transcodeCtx->encContextInfoPtr->encodeFrame(framePtr);
+            transcodeCtx->encContextInfoPtr->encodeFrame(framePtr, packetPtrs);
         }
         auto outStreamIndex = transcodeCtx->outStreamIndex;
         for (const auto &packetPtr : std::as_const(packetPtrs)) {
@@ -401,13 +402,14 @@ public:
     {
         contextInfo->setIndex(index);
         contextInfo->setStream(inFormatContext->stream(index));
-        return contextInfo->initDecoder(inFormatContext->guessFrameRate(index));
+        return contextInfo->initDecoder(inFormatContext->guessFrameRate(index),
+                                        threadingPolicy);
     }
 
     void loop()
     {
         while (runing.load()) {
-            PacketPtr packetPtr(new Packet);
+            auto packetPtr = packetPool.acquire();
             if (!inFormatContext->readFrame(packetPtr.get())) {
                 break;
             }
@@ -427,13 +429,15 @@ public:
                 outFormatContext->writePacket(packetPtr.data());
             } else {
                 packetPtr->rescaleTs(inTimebase, transcodeCtx->decContextInfoPtr->timebase());
-                auto framePtrs = transcodeCtx->decContextInfoPtr->decodeFrame(packetPtr);
-                for (const auto &framePtr : std::as_const(framePtrs)) {
+                decodedFrames.clear();
+                transcodeCtx->decContextInfoPtr->decodeFrame(packetPtr, decodedFrames);
+                for (const auto &framePtr : std::as_const(decodedFrames)) {
                     if (!transcodeCtx->filterPtr->isInitialized()) {
                         initFilters(stream_index, framePtr);
                     }
                     filterEncodeWriteframe(framePtr, stream_index);
                 }
+                decodedFrames.clear();
 
                 calculatePts(packetPtr.data(), decContextInfoPtr.data());
                 addPropertyChangeEvent(new PositionEvent(packetPtr->pts()));
@@ -510,8 +514,13 @@ public:
 
     std::atomic_bool runing = true;
     QScopedPointer<Utils::Fps> fpsPtr;
+    PacketPool packetPool;
+    // reused by every decodeFrame call of the loop
+    std::vector<FramePtr> decodedFrames;
 
     bool gpuDecode = true;
+    ThreadingPolicy threadingPolicy = ThreadingPolicy::transcode();
+    qint64 prefetchSize = 0;
 
     Utils::ThreadSafeQueue<PropertyChangeEventPtr> propertyChangeEventQueue;
     std::atomic<size_t> maxPropertyEventQueueSize = 100;
@@ -563,7 +572,7 @@ void Transcoder::startPreviewFrames(int count)
     d_ptr->threadPool->start(new PreviewCountTask(d_ptr->inFilePath, count, this));
 }
 
-void Transcoder::setPreviewFrames(const std::vector<QSharedPointer<Frame>> &framePtrs)
+void Transcoder::setPreviewFrames(const std::vector<FramePtr> &framePtrs)
 {
     QMetaObject::invokeMethod(
         this,
@@ -576,7 +585,7 @@ void Transcoder::setPreviewFrames(const std::vector<QSharedPointer<Frame>> &fram
         Qt::QueuedConnection);
 }
 
-auto Transcoder::previewFrames() const -> std::vector<QSharedPointer<Frame>>
+auto Transcoder::previewFrames() const -> std::vector<FramePtr>
 {
     return d_ptr->previewFrames;
 }
@@ -596,6 +605,26 @@ auto Transcoder::isGpuDecode() -> bool
     return d_ptr->gpuDecode;
 }
 
+void Transcoder::setThreadingPolicy(const ThreadingPolicy &threadingPolicy)
+{
+    d_ptr->threadingPolicy = threadingPolicy;
+}
+
+auto Transcoder::threadingPolicy() const -> ThreadingPolicy
+{
+    return d_ptr->threadingPolicy;
+}
+
+void Transcoder::setPrefetchSize(qint64 bytes)
+{
+    d_ptr->prefetchSize = bytes;
+}
+
+auto Transcoder::prefetchSize() const -> qint64
+{
+    return d_ptr->prefetchSize;
+}
+
 void Transcoder::setEncodeContexts(const EncodeContexts &encodeContexts)
 {
     for (int i = 0; i < encodeContexts.size(); i++) {
@@ -649,6 +678,11 @@ auto Transcoder::fps() -> float
     return d_ptr->fpsPtr->getFps();
 }
 
+auto Transcoder::packetPool() -> PacketPool *
+{
+    return &d_ptr->packetPool;
+}
+
 void Transcoder::setPropertyEventQueueMaxSize(size_t size)
 {
     d_ptr->maxPropertyEventQueueSize.store(size);
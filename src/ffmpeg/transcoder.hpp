@@ -2,7 +2,9 @@
 #define TRANSCODER_H
 
 #include "encodecontext.hpp"
+#include "frame.hpp"
 #include "mediainfo.hpp"
+#include "threadingpolicy.hpp"
 
 #include <ffmpeg/event/event.hpp>
 
@@ -15,7 +17,7 @@ extern "C" {
 namespace Ffmpeg {
 
 class AVError;
-class Frame;
+class PacketPool;
 class FFMPEG_EXPORT Transcoder : public QThread
 {
     Q_OBJECT
@@ -31,14 +33,22 @@ public:
     void setGpuDecode(bool enable);
     auto isGpuDecode() -> bool;
 
+    // threads of the input decoders, set before startTranscode
+    void setThreadingPolicy(const ThreadingPolicy &threadingPolicy);
+    [[nodiscard]] auto threadingPolicy() const -> ThreadingPolicy;
+
+    // bytes the input is read ahead on an I/O thread, 0 disables, set before startTranscode
+    void setPrefetchSize(qint64 bytes);
+    [[nodiscard]] auto prefetchSize() const -> qint64;
+
     void setEncodeContexts(const EncodeContexts &encodeContexts);
     [[nodiscard]] auto decodeContexts() const -> EncodeContexts;
 
     [[nodiscard]] auto duration() const -> qint64; // microsecond
     auto mediaInfo() -> MediaInfo;
     void startPreviewFrames(int count);
-    void setPreviewFrames(const std::vector<QSharedPointer<Frame>> &framePtrs);
-    [[nodiscard]] auto previewFrames() const -> std::vector<QSharedPointer<Frame>>;
+    void setPreviewFrames(const std::vector<FramePtr> &framePtrs);
+    [[nodiscard]] auto previewFrames() const -> std::vector<FramePtr>;
 
     void setRange(const QPair<qint64, qint64> &range);
 
@@ -49,6 +59,9 @@ public:
 
     auto fps() -> float;
 
+    // allocation counters of the transcode loop
+    auto packetPool() -> PacketPool *;
+
     void setPropertyEventQueueMaxSize(size_t size);
     [[nodiscard]] auto propertEventyQueueMaxSize() const -> size_t;
     [[nodiscard]] auto propertyChangeEventSize() const -> size_t;
@@ -16,7 +16,7 @@ extern "C" {
 namespace Ffmpeg {
 
 auto TranscoderContext::initFilter(const QString &filter_spec,
-                                   const QSharedPointer<Frame> &framePtr) const -> bool
+                                   const FramePtr &framePtr) const -> bool
 {
     if (filterPtr->isInitialized()) {
         return true;
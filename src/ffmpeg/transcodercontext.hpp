@@ -1,11 +1,12 @@
 #ifndef TRANSCODERCONTEXT_HPP
 #define TRANSCODERCONTEXT_HPP
 
+#include "frame.hpp"
+
 #include <QSharedPointer>
 
 namespace Ffmpeg {
 
-class Frame;
 class AVContextInfo;
 class Filter;
 class AudioFifo;
@@ -13,7 +14,7 @@ class AudioFifo;
 struct TranscoderContext
 {
     [[nodiscard]] auto initFilter(const QString &filter_spec,
-                                  const QSharedPointer<Frame> &framePtr) const -> bool;
+                                  const FramePtr &framePtr) const -> bool;
 
     QSharedPointer<AVContextInfo> decContextInfoPtr;
     QSharedPointer<AVContextInfo> encContextInfoPtr;
@@ -1,5 +1,6 @@
 #include "videodecoder.h"
 #include "avcontextinfo.h"
+#include "codeccontext.h"
 #include "ffmpegutils.hpp"
 #include "videodisplay.hpp"
 #include "videoformat.hpp"
@@ -8,27 +9,44 @@
 
 #include <QDebug>
 
+#include <deque>
+
+extern "C" {
+#include <libavutil/avutil.h>
+}
+
 namespace Ffmpeg {
 
+// display lateness that makes the decoder skip work, the display drops frames past 100 ms
+static constexpr auto s_skipNonRefLateness = 50 * 1000;      // microseconds
+static constexpr auto s_skipLoopFilterLateness = 100 * 1000; // microseconds
+// back to full decoding, below the entry points so the level does not flap
+static constexpr auto s_skipRecoverLateness = 15 * 1000; // microseconds
+static constexpr auto s_noSeekTarget = std::numeric_limits<qint64>::min();
+
 class VideoDecoder::VideoDecoderPrivate
 {
 public:
-    explicit VideoDecoderPrivate(VideoDecoder *q)
+    explicit VideoDecoderPrivate(ClockDomain *clockDomain, VideoDecoder *q)
         : q_ptr(q)
     {
-        decoderVideoFrame = new VideoDisplay(q_ptr);
+        decoderVideoFrame = new VideoDisplay(clockDomain, q_ptr);
     }
 
-    void processEvent() const
+    void processEvent()
     {
         while (q_ptr->m_runing.load() && !q_ptr->m_eventQueue.empty()) {
             auto eventPtr = q_ptr->m_eventQueue.take();
             switch (eventPtr->type()) {
-            case Event::EventType::Pause: decoderVideoFrame->addEvent(eventPtr); break;
+            case Event::EventType::Pause:
+            case Event::EventType::Buffering: decoderVideoFrame->addEvent(eventPtr); break;
             case Event::EventType::Seek: {
                 auto *seekEvent = static_cast<SeekEvent *>(eventPtr.data());
                 seekEvent->countDown();
                 q_ptr->clear();
+                framePtrs.clear();
+                setSkipLevel(SkipLevel::None);
+                seekTarget = seekEvent->isAccurate() ? seekEvent->position() : s_noSeekTarget;
                 decoderVideoFrame->addEvent(eventPtr);
             } break;
             default: break;
@@ -36,19 +54,94 @@ public:
         }
     }
 
+    // decoded frames the display queue could not take yet
+    auto flushFrames() -> bool
+    {
+        while (!framePtrs.empty()) {
+            if (!decoderVideoFrame->tryAppend(std::move(framePtrs.front()))) {
+                return false;
+            }
+            framePtrs.pop_front();
+        }
+        return true;
+    }
+
+    enum class SkipLevel : int { None, NonRef, LoopFilter };
+
+    // nothing depends on non reference frames, skipping them is the cheapest way to catch up;
+    // further behind, all frames lose deblocking and b frames the idct.
+    // The pre-roll of an accurate seek is never shown, its non reference frames are skipped too,
+    // reference frames are decoded in full as the frames at the target are built on them.
+    void updateSkipLevel(const PacketPtr &packetPtr)
+    {
+        if (seekTarget != s_noSeekTarget) {
+            auto *avPacket = packetPtr->avPacket();
+            auto pts = avPacket->pts != AV_NOPTS_VALUE ? avPacket->pts : avPacket->dts;
+            if (pts != AV_NOPTS_VALUE
+                && av_rescale_q(pts, q_ptr->m_contextInfo->timebase(), AVRational{1, AV_TIME_BASE})
+                       < seekTarget) {
+                setSkipLevel(SkipLevel::NonRef);
+                return;
+            }
+        }
+        auto lateness = decoderVideoFrame->lateness();
+        auto level = skipLevel;
+        if (lateness >= s_skipLoopFilterLateness) {
+            level = SkipLevel::LoopFilter;
+        } else if (lateness >= s_skipNonRefLateness) {
+            level = SkipLevel::NonRef;
+        } else if (lateness <= s_skipRecoverLateness) {
+            level = SkipLevel::None;
+        }
+        setSkipLevel(level);
+    }
+
+    void setSkipLevel(SkipLevel level)
+    {
+        if (level == skipLevel) {
+            return;
+        }
+        switch (level) {
+        case SkipLevel::None:
+            q_ptr->m_contextInfo->codecCtx()->setSkip(AVDISCARD_DEFAULT,
+                                                      AVDISCARD_DEFAULT,
+                                                      AVDISCARD_DEFAULT);
+            break;
+        case SkipLevel::NonRef:
+            q_ptr->m_contextInfo->codecCtx()->setSkip(AVDISCARD_NONREF,
+                                                      AVDISCARD_DEFAULT,
+                                                      AVDISCARD_DEFAULT);
+            break;
+        case SkipLevel::LoopFilter:
+            q_ptr->m_contextInfo->codecCtx()->setSkip(AVDISCARD_NONREF,
+                                                      AVDISCARD_ALL,
+                                                      AVDISCARD_BIDIR);
+            break;
+        }
+        if (level > skipLevel) {
+            skipRaisedNum++;
+        }
+        skipLevel = level;
+    }
+
     VideoDecoder *q_ptr;
 
     VideoDisplay *decoderVideoFrame;
+    std::deque<FramePtr> framePtrs;
+    // reused by every decodeFrame call
+    std::vector<FramePtr> decodedFrames;
+
+    SkipLevel skipLevel = SkipLevel::None;
+    quint64 skipRaisedNum = 0;
+    // microseconds, frames before it are dropped until the first one at or after it is decoded
+    qint64 seekTarget = s_noSeekTarget;
 };
 
-VideoDecoder::VideoDecoder(QObject *parent)
+VideoDecoder::VideoDecoder(ClockDomain *clockDomain, QObject *parent)
     : Decoder<PacketPtr>(parent)
-    , d_ptr(new VideoDecoderPrivate(this))
+    , d_ptr(new VideoDecoderPrivate(clockDomain, this))
 {
-    connect(d_ptr->decoderVideoFrame,
-            &VideoDisplay::positionChanged,
-            this,
-            &VideoDecoder::positionChanged);
+    d_ptr->decoderVideoFrame->setUpstream([this] { notify(); });
 }
 
 VideoDecoder::~VideoDecoder()
@@ -66,27 +159,51 @@ void VideoDecoder::setMasterClock()
     d_ptr->decoderVideoFrame->setMasterClock();
 }
 
-void VideoDecoder::runDecoder()
+void VideoDecoder::onDecoderStarted()
 {
+    d_ptr->skipLevel = VideoDecoderPrivate::SkipLevel::None;
+    d_ptr->skipRaisedNum = 0;
+    d_ptr->seekTarget = s_noSeekTarget;
+    d_ptr->decoderVideoFrame->setUseSharedExecutor(useSharedExecutor());
+    d_ptr->decoderVideoFrame->setLowLatency(lowLatency());
     d_ptr->decoderVideoFrame->startDecoder(m_formatContext, m_contextInfo);
+}
 
-    while (m_runing) {
-        d_ptr->processEvent();
+void VideoDecoder::onDecoderStopped()
+{
+    d_ptr->framePtrs.clear();
+    d_ptr->decoderVideoFrame->stopDecoder();
+    d_ptr->setSkipLevel(VideoDecoderPrivate::SkipLevel::None);
+    qInfo() << "Video Decoder Skip Raised Num:" << d_ptr->skipRaisedNum;
+}
 
-        auto packetPtr(m_queue.take());
-        if (packetPtr.isNull()) {
-            continue;
-        }
-        auto framePtrs = m_contextInfo->decodeFrame(packetPtr);
-        for (const auto &framePtr : framePtrs) {
-            calculatePts(framePtr.data(), m_contextInfo, m_formatContext);
-            d_ptr->decoderVideoFrame->append(framePtr);
-        }
+auto VideoDecoder::runDecoderStep() -> bool
+{
+    d_ptr->processEvent();
+    if (!d_ptr->flushFrames()) {
+        return false;
+    }
+
+    PacketPtr packetPtr;
+    if (!m_queue.tryTake(packetPtr)) {
+        return false;
     }
-    while (m_runing && d_ptr->decoderVideoFrame->size() != 0) {
-        msleep(s_waitQueueEmptyMilliseconds);
+    if (packetPtr.isNull()) {
+        return true;
     }
-    d_ptr->decoderVideoFrame->stopDecoder();
+    d_ptr->updateSkipLevel(packetPtr);
+    d_ptr->decodedFrames.clear();
+    m_contextInfo->decodeFrame(packetPtr, d_ptr->decodedFrames, d_ptr->seekTarget);
+    if (!d_ptr->decodedFrames.empty()) {
+        d_ptr->seekTarget = s_noSeekTarget;
+    }
+    for (const auto &framePtr : d_ptr->decodedFrames) {
+        calculatePts(framePtr.data(), m_contextInfo, m_formatContext);
+        d_ptr->framePtrs.push_back(framePtr);
+    }
+    d_ptr->decodedFrames.clear();
+    d_ptr->flushFrames();
+    return true;
 }
 
 } // namespace Ffmpeg
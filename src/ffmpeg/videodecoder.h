@@ -6,24 +6,24 @@
 
 namespace Ffmpeg {
 
+class ClockDomain;
 class VideoRender;
 
 class VideoDecoder : public Decoder<PacketPtr>
 {
     Q_OBJECT
 public:
-    explicit VideoDecoder(QObject *parent = nullptr);
+    explicit VideoDecoder(ClockDomain *clockDomain, QObject *parent = nullptr);
     ~VideoDecoder() override;
 
     void setVideoRenders(const QVector<VideoRender *> &videoRenders);
 
     void setMasterClock();
 
-signals:
-    void positionChanged(qint64 position); // microsecond
-
 protected:
-    void runDecoder() override;
+    void onDecoderStarted() override;
+    void onDecoderStopped() override;
+    auto runDecoderStep() -> bool override;
 
 private:
     class VideoDecoderPrivate;
@@ -1,13 +1,16 @@
 #include "videodisplay.hpp"
 #include "clock.hpp"
+#include "presentationscheduler.hpp"
 
 #include <event/seekevent.hpp>
 #include <event/valueevent.hpp>
 #include <videorender/videorender.hpp>
 
 #include <QDebug>
+#include <QScreen>
 #include <QTime>
-#include <QWaitCondition>
+
+#include <atomic>
 
 extern "C" {
 #include <libavutil/time.h>
@@ -15,24 +18,54 @@ extern "C" {
 
 namespace Ffmpeg {
 
+// on its own thread, park wakeups are millisecond based and late, wake this early and sleep
+// the rest precisely
+static constexpr auto s_coarseWakeupMargin = 2000; // microseconds
+
 class VideoDisplay::VideoDisplayPrivate
 {
 public:
-    explicit VideoDisplayPrivate(VideoDisplay *q)
+    explicit VideoDisplayPrivate(ClockDomain *clockDomain, VideoDisplay *q)
         : q_ptr(q)
     {
-        clock = new Clock(q);
+        clock = new Clock(clockDomain, q);
+        scheduler = new PresentationScheduler(q);
     }
 
-    void renderFrame(const QSharedPointer<Frame> &framePtr)
+    // convert for every render while waiting for the deadline, not after it
+    void prepareFrame()
     {
         QMutexLocker locker(&mutex_render);
+        preparedFrames.clear();
         for (auto *render : videoRenders) {
-            render->setFrame(framePtr);
+            preparedFrames.emplace_back(render, render->prepareFrame(framePtr));
         }
     }
 
-    void processEvent(bool &firstFrame) const
+    void presentFrame()
+    {
+        QMutexLocker locker(&mutex_render);
+        for (auto *render : videoRenders) {
+            auto iter = std::find_if(preparedFrames.begin(),
+                                     preparedFrames.end(),
+                                     [render](const auto &prepared) {
+                                         return prepared.first == render;
+                                     });
+            // renders set after prepareFrame convert now
+            render->presentFrame(iter != preparedFrames.end() ? iter->second
+                                                               : render->prepareFrame(framePtr));
+        }
+        preparedFrames.clear();
+    }
+
+    void resetFrame()
+    {
+        framePtr.reset();
+        QMutexLocker locker(&mutex_render);
+        preparedFrames.clear();
+    }
+
+    void processEvent()
     {
         while (q_ptr->m_runing.load() && !q_ptr->m_eventQueue.empty()) {
             qDebug() << "DecoderVideoFrame::processEvent";
@@ -42,9 +75,17 @@ public:
                 auto *pauseEvent = static_cast<PauseEvent *>(eventPtr.data());
                 auto paused = pauseEvent->paused();
                 clock->setPaused(paused);
+                scheduler->reset();
+            } break;
+            case Event::EventType::Buffering: {
+                auto *bufferingEvent = static_cast<BufferingEvent *>(eventPtr.data());
+                setHolding(bufferingEvent->buffering());
             } break;
             case Event::EventType::Seek: {
                 q_ptr->clear();
+                resetFrame();
+                scheduler->reset();
+                lag.store(0);
                 firstFrame = false;
             }
             default: break;
@@ -52,20 +93,47 @@ public:
         }
     }
 
+    // nothing is presented, the held frame is presented as much later
+    void setHolding(bool value)
+    {
+        if (holding == value) {
+            return;
+        }
+        holding = value;
+        clock->setPaused(holding);
+        scheduler->reset();
+        auto now = av_gettime_relative();
+        if (holding) {
+            holdTime = now;
+        } else {
+            renderTime += now - holdTime;
+        }
+    }
+
     VideoDisplay *q_ptr;
 
     Clock *clock;
+    PresentationScheduler *scheduler;
 
-    QMutex mutex;
-    QWaitCondition waitCondition;
+    bool firstFrame = false;
+    quint64 dropNum = 0;
+    // microseconds the last frame taken was behind the master clock, read by the decoder
+    std::atomic<qint64> lag = 0;
+    // frame waiting for its render time
+    FramePtr framePtr;
+    qint64 renderTime = 0;
+    bool holding = false;
+    qint64 holdTime = 0;
 
     QMutex mutex_render;
     QVector<VideoRender *> videoRenders = {};
+    // framePtr converted for each render, reused between frames
+    std::vector<std::pair<VideoRender *, FramePtr>> preparedFrames;
 };
 
-VideoDisplay::VideoDisplay(QObject *parent)
+VideoDisplay::VideoDisplay(ClockDomain *clockDomain, QObject *parent)
     : Decoder<FramePtr>(parent)
-    , d_ptr(new VideoDisplayPrivate(this))
+    , d_ptr(new VideoDisplayPrivate(clockDomain, this))
 {}
 
 VideoDisplay::~VideoDisplay()
@@ -75,55 +143,109 @@ VideoDisplay::~VideoDisplay()
 
 void VideoDisplay::setVideoRenders(const QVector<VideoRender *> &videoRenders)
 {
+    qreal refreshRate = 0;
+    for (auto *render : videoRenders) {
+        auto *widget = render->widget();
+        if (widget != nullptr && widget->screen() != nullptr) {
+            refreshRate = qMax(refreshRate, widget->screen()->refreshRate());
+        }
+    }
+    setRefreshRate(refreshRate);
+
     QMutexLocker locker(&d_ptr->mutex_render);
     d_ptr->videoRenders = videoRenders;
 }
 
+void VideoDisplay::setRefreshRate(qreal refreshRate)
+{
+    d_ptr->scheduler->setRefreshInterval(refreshRate > 0 ? qRound64(AV_TIME_BASE / refreshRate)
+                                                         : 0);
+}
+
+auto VideoDisplay::lateness() const -> qint64
+{
+    return qMax(d_ptr->lag.load(), d_ptr->scheduler->averageLateness());
+}
+
 void VideoDisplay::setMasterClock()
 {
-    Clock::setMaster(d_ptr->clock);
+    d_ptr->clock->domain()->setMaster(d_ptr->clock);
 }
 
-void VideoDisplay::runDecoder()
+void VideoDisplay::onDecoderStarted()
 {
     for (auto *render : d_ptr->videoRenders) {
         render->resetFps();
     }
-    quint64 dropNum = 0;
-    bool firstFrame = false;
-    while (m_runing.load()) {
-        d_ptr->processEvent(firstFrame);
+    d_ptr->dropNum = 0;
+    d_ptr->lag.store(0);
+    d_ptr->firstFrame = false;
+    d_ptr->holding = false;
+    d_ptr->resetFrame();
+    d_ptr->scheduler->reset();
+}
 
-        auto framePtr(m_queue.take());
+void VideoDisplay::onDecoderStopped()
+{
+    d_ptr->resetFrame();
+    qInfo() << "Video Drop Num:" << d_ptr->dropNum
+            << "Late Num:" << d_ptr->scheduler->lateCount()
+            << "Average Lateness:" << d_ptr->scheduler->averageLateness() << "us";
+}
+
+auto VideoDisplay::runDecoderStep() -> bool
+{
+    d_ptr->processEvent();
+    if (d_ptr->holding) {
+        return false;
+    }
+
+    if (d_ptr->framePtr.isNull()) {
+        FramePtr framePtr;
+        if (!m_queue.tryTake(framePtr)) {
+            return false;
+        }
         if (framePtr.isNull()) {
-            continue;
+            return true;
         }
-        if (!firstFrame) {
+        if (!d_ptr->firstFrame) {
             qDebug() << "Video firstFrame: "
                      << QTime::fromMSecsSinceStartOfDay(framePtr->pts() / 1000)
                             .toString("hh:mm:ss.zzz");
-            firstFrame = true;
+            d_ptr->firstFrame = true;
             d_ptr->clock->reset(framePtr->pts());
         }
         auto pts = framePtr->pts();
         d_ptr->clock->update(pts, av_gettime_relative());
         qint64 delay = 0;
         if (!d_ptr->clock->getDelayWithMaster(delay)) {
-            continue;
+            return true;
         }
-        auto emitPosition = qScopeGuard([=]() { emit positionChanged(pts); });
+        d_ptr->lag.store(qMax(-delay, qint64(0)));
         if (!d_ptr->clock->adjustDelay(delay)) {
             qDebug() << "Video Delay: " << delay;
-            dropNum++;
-            continue;
-        }
-        if (delay > 0) {
-            QMutexLocker locker(&d_ptr->mutex);
-            d_ptr->waitCondition.wait(&d_ptr->mutex, delay / 1000);
+            d_ptr->dropNum++;
+            return true;
         }
-        d_ptr->renderFrame(framePtr);
+        d_ptr->framePtr = framePtr;
+        d_ptr->renderTime = d_ptr->scheduler->target(av_gettime_relative() + delay);
+        d_ptr->prepareFrame();
+    }
+
+    // a shared executor thread must not sleep or spin in a step, the executor timer never fires
+    // early, so the frame is presented as soon as it fires
+    auto margin = useSharedExecutor() ? 0 : s_coarseWakeupMargin;
+    if (av_gettime_relative() < d_ptr->renderTime - margin) {
+        wakeupAt(d_ptr->renderTime - margin);
+        return false;
+    }
+    if (!useSharedExecutor()) {
+        PresentationScheduler::sleepUntil(d_ptr->renderTime);
     }
-    qInfo() << "Video Drop Num:" << dropNum;
+    d_ptr->presentFrame();
+    d_ptr->scheduler->presented(d_ptr->renderTime, av_gettime_relative());
+    d_ptr->framePtr.reset();
+    return true;
 }
 
 } // namespace Ffmpeg
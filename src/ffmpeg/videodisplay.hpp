@@ -6,24 +6,31 @@
 
 namespace Ffmpeg {
 
+class ClockDomain;
 class VideoRender;
 
 class VideoDisplay : public Decoder<FramePtr>
 {
     Q_OBJECT
 public:
-    explicit VideoDisplay(QObject *parent = nullptr);
+    explicit VideoDisplay(ClockDomain *clockDomain, QObject *parent = nullptr);
     ~VideoDisplay() override;
 
+    // also takes the refresh rate of the screens the renders are on
     void setVideoRenders(const QVector<VideoRender *> &videoRenders);
+    // Hz, frames are aligned to the refresh grid, <= 0 if unknown
+    void setRefreshRate(qreal refreshRate);
 
-    void setMasterClock();
+    // microseconds, how far behind the master clock frames arrive or how late they are presented,
+    // whichever is worse, thread safe
+    [[nodiscard]] auto lateness() const -> qint64;
 
-signals:
-    void positionChanged(qint64 position); // microsecond
+    void setMasterClock();
 
 protected:
-    void runDecoder() override;
+    void onDecoderStarted() override;
+    void onDecoderStopped() override;
+    auto runDecoderStep() -> bool override;
 
 private:
     class VideoDisplayPrivate;
@@ -4,6 +4,7 @@
 
 #include <ffmpeg/colorutils.hpp>
 #include <ffmpeg/frame.hpp>
+#include <ffmpeg/imagebufferpool.hpp>
 #include <ffmpeg/subtitle.h>
 #include <ffmpeg/videoframeconverter.hpp>
 #include <mediaconfig/equalizer.hpp>
@@ -22,7 +23,9 @@ class OpenglRender::OpenglRenderPrivate
 public:
     explicit OpenglRenderPrivate(OpenglRender *q)
         : q_ptr(q)
-    {}
+    {
+        imageBufferPool = new ImageBufferPool(q_ptr);
+    }
     ~OpenglRenderPrivate() = default;
 
     OpenglRender *q_ptr;
@@ -56,8 +59,9 @@ public:
                                                    AV_PIX_FMT_BGRA,
                                                    AV_PIX_FMT_P010LE};
     QScopedPointer<VideoFrameConverter> frameConverterPtr;
+    ImageBufferPool *imageBufferPool;
 
-    QSharedPointer<Frame> framePtr;
+    FramePtr framePtr;
     bool frameChanged = true;
     QSharedPointer<Subtitle> subTitleFramePtr;
     bool subChanged = true;
@@ -91,8 +95,7 @@ auto OpenglRender::isSupportedOutput_pix_fmt(AVPixelFormat pix_fmt) -> bool
     return d_ptr->supportFormats.contains(pix_fmt);
 }
 
-auto OpenglRender::convertSupported_pix_fmt(const QSharedPointer<Frame> &frame)
-    -> QSharedPointer<Frame>
+auto OpenglRender::convertSupported_pix_fmt(const FramePtr &frame) -> FramePtr
 {
     auto dst_pix_fmt = AV_PIX_FMT_RGBA;
     auto *avframe = frame->avFrame();
@@ -104,8 +107,8 @@ auto OpenglRender::convertSupported_pix_fmt(const QSharedPointer<Frame> &frame)
     } else {
         d_ptr->frameConverterPtr->flush(frame.data(), size, dst_pix_fmt);
     }
-    QSharedPointer<Frame> frameRgbPtr(new Frame);
-    auto ret = frameRgbPtr->imageAlloc(size, dst_pix_fmt);
+    FramePtr frameRgbPtr(new Frame);
+    auto ret = d_ptr->imageBufferPool->imageAlloc(frameRgbPtr.data(), size, dst_pix_fmt);
     if (!ret) {
         qWarning() << "imageAlloc failed";
         return {};
@@ -132,7 +135,7 @@ auto OpenglRender::widget() -> QWidget *
     return this;
 }
 
-void OpenglRender::updateFrame(const QSharedPointer<Frame> &framePtr)
+void OpenglRender::updateFrame(const FramePtr &framePtr)
 {
     QMetaObject::invokeMethod(
         this, [=] { onUpdateFrame(framePtr); }, Qt::QueuedConnection);
@@ -239,7 +242,7 @@ void OpenglRender::resetShader(Frame *frame)
     doneCurrent();
 }
 
-void OpenglRender::onUpdateFrame(const QSharedPointer<Frame> &framePtr)
+void OpenglRender::onUpdateFrame(const FramePtr &framePtr)
 {
     if (d_ptr->framePtr.isNull()
         || d_ptr->framePtr->avFrame()->format != framePtr->avFrame()->format
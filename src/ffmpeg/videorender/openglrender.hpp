@@ -19,8 +19,7 @@ public:
     ~OpenglRender() override;
 
     auto isSupportedOutput_pix_fmt(AVPixelFormat pix_fmt) -> bool override;
-    auto convertSupported_pix_fmt(const QSharedPointer<Frame> &frame)
-        -> QSharedPointer<Frame> override;
+    auto convertSupported_pix_fmt(const FramePtr &frame) -> FramePtr override;
     auto supportedOutput_pix_fmt() -> QVector<AVPixelFormat> override;
 
     void resetAllFrame() override;
@@ -32,7 +31,7 @@ protected:
     void resizeGL(int w, int h) override;
     void paintGL() override;
 
-    void updateFrame(const QSharedPointer<Frame> &framePtr) override;
+    void updateFrame(const FramePtr &framePtr) override;
     void updateSubTitleFrame(const QSharedPointer<Subtitle> &framePtr) override;
 
 private:
@@ -44,7 +43,7 @@ private:
     void cleanup();
     void resetShader(Frame *frame);
 
-    void onUpdateFrame(const QSharedPointer<Frame> &framePtr);
+    void onUpdateFrame(const FramePtr &framePtr);
     void onUpdateSubTitleFrame(const QSharedPointer<Subtitle> &framePtr);
 
     void paintVideoFrame();
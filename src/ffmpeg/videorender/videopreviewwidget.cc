@@ -37,7 +37,7 @@ public:
     QImage image;
     qint64 timestamp;
     qint64 duration;
-    QSharedPointer<Frame> framePtr;
+    FramePtr framePtr;
     QString chapterText;
     QString displayText;
 
@@ -81,7 +81,7 @@ void VideoPreviewWidget::clearAllTask()
     d_ptr->threadPool->clear();
 }
 
-void VideoPreviewWidget::setDisplayImage(const QSharedPointer<Frame> &framePtr,
+void VideoPreviewWidget::setDisplayImage(const FramePtr &framePtr,
                                          const QImage &image,
                                          qint64 pts,
                                          const QString &chapterText)
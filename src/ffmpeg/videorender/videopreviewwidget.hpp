@@ -4,11 +4,10 @@
 #include <QWidget>
 
 #include <ffmpeg/ffmepg_global.h>
+#include <ffmpeg/frame.hpp>
 
 namespace Ffmpeg {
 
-class Frame;
-
 class FFMPEG_EXPORT VideoPreviewWidget : public QWidget
 {
     Q_OBJECT
@@ -19,7 +18,7 @@ public:
     void startPreview(const QString &filepath, int videoIndex, qint64 timestamp, qint64 duration);
     void clearAllTask();
 
-    void setDisplayImage(const QSharedPointer<Ffmpeg::Frame> &framePtr,
+    void setDisplayImage(const Ffmpeg::FramePtr &framePtr,
                          const QImage &image,
                          qint64 pts,
                          const QString &chapterText);
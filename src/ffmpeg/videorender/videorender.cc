@@ -35,15 +35,25 @@ VideoRender::VideoRender()
 
 VideoRender::~VideoRender() = default;
 
-void VideoRender::setFrame(QSharedPointer<Frame> framePtr)
+void VideoRender::setFrame(FramePtr framePtr)
+{
+    presentFrame(prepareFrame(std::move(framePtr)));
+}
+
+auto VideoRender::prepareFrame(FramePtr framePtr) -> FramePtr
 {
     auto *avFrame = framePtr->avFrame();
     if (avFrame->width <= 0 || avFrame->height <= 0) {
-        return;
+        return {};
     }
     if (!isSupportedOutput_pix_fmt(static_cast<AVPixelFormat>(avFrame->format))) {
         framePtr = convertSupported_pix_fmt(framePtr);
     }
+    return framePtr;
+}
+
+void VideoRender::presentFrame(const FramePtr &framePtr)
+{
     if (framePtr.isNull()) {
         return;
     }
@@ -57,7 +67,7 @@ void VideoRender::setImage(const QImage &image)
     if (image.isNull()) {
         return;
     }
-    QSharedPointer<Frame> frame(Frame::fromQImage(image));
+    FramePtr frame(Frame::fromQImage(image));
     setFrame(frame);
 }
 
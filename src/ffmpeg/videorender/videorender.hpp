@@ -5,6 +5,7 @@
 
 #include <ffmpeg/colorutils.hpp>
 #include <ffmpeg/ffmepg_global.h>
+#include <ffmpeg/frame.hpp>
 #include <mediaconfig/equalizer.hpp>
 
 #include <QWidget>
@@ -15,7 +16,6 @@ extern "C" {
 
 namespace Ffmpeg {
 
-class Frame;
 class Subtitle;
 
 class FFMPEG_EXPORT VideoRender
@@ -27,10 +27,14 @@ public:
 
     virtual auto isSupportedOutput_pix_fmt(AVPixelFormat pix_fmt) -> bool = 0;
     virtual auto supportedOutput_pix_fmt() -> QVector<AVPixelFormat> = 0;
-    virtual auto convertSupported_pix_fmt(const QSharedPointer<Frame> &framePtr)
-        -> QSharedPointer<Frame>
-        = 0;
-    void setFrame(QSharedPointer<Frame> framePtr);
+    virtual auto convertSupported_pix_fmt(const FramePtr &framePtr) -> FramePtr = 0;
+    // prepareFrame + presentFrame
+    void setFrame(FramePtr framePtr);
+    // pixel format conversion, can run ahead of the presentation time,
+    // null if the frame cannot be shown
+    auto prepareFrame(FramePtr framePtr) -> FramePtr;
+    // shows a frame returned by prepareFrame
+    void presentFrame(const FramePtr &framePtr);
     void setImage(const QImage &image);
     void setSubTitleFrame(const QSharedPointer<Subtitle> &framePtr);
     virtual void resetAllFrame() = 0;
@@ -57,7 +61,7 @@ public:
 
 protected:
     // may use in anthoer thread, suggest use QMetaObject::invokeMethod(Qt::QueuedConnection)
-    virtual void updateFrame(const QSharedPointer<Frame> &framePtr) = 0;
+    virtual void updateFrame(const FramePtr &framePtr) = 0;
     virtual void updateSubTitleFrame(const QSharedPointer<Subtitle> &framePtr) = 0;
 
     MediaConfig::Equalizer m_equalizer;
@@ -2,6 +2,7 @@
 
 #include <ffmpeg/ffmpegutils.hpp>
 #include <ffmpeg/frame.hpp>
+#include <ffmpeg/imagebufferpool.hpp>
 #include <ffmpeg/subtitle.h>
 #include <ffmpeg/videoformat.hpp>
 #include <ffmpeg/videoframeconverter.hpp>
@@ -56,7 +57,9 @@ class WidgetRender::WidgetRenderPrivate
 public:
     explicit WidgetRenderPrivate(WidgetRender *q)
         : q_ptr(q)
-    {}
+    {
+        imageBufferPool = new ImageBufferPool(q_ptr);
+    }
 
     ~WidgetRenderPrivate() = default;
 
@@ -75,8 +78,8 @@ public:
                                                 q_ptr->m_equalizer.ffBrightness(),
                                                 q_ptr->m_equalizer.ffContrast(),
                                                 q_ptr->m_equalizer.ffSaturation());
-        QSharedPointer<Frame> frameRgbPtr(new Frame);
-        frameRgbPtr->imageAlloc(size, dst_pix_fmt);
+        FramePtr frameRgbPtr(new Frame);
+        imageBufferPool->imageAlloc(frameRgbPtr.data(), size, dst_pix_fmt);
         frameConverterPtr->scale(framePtr.data(), frameRgbPtr.data());
         //    qDebug() << frameRgbPtr->avFrame()->width << frameRgbPtr->avFrame()->height
         //             << frameRgbPtr->avFrame()->format;
@@ -129,11 +132,12 @@ public:
 
     QSizeF size;
     QRectF frameRect;
-    QSharedPointer<Frame> framePtr;
+    FramePtr framePtr;
     // Rendering is best optimized to the Format_RGB32 and Format_ARGB32_Premultiplied formats
     //QList<AVPixelFormat> supportFormats = VideoFormat::qFormatMaps.keys();
     QList<AVPixelFormat> supportFormats = {AV_PIX_FMT_RGB32};
     QScopedPointer<VideoFrameConverter> frameConverterPtr;
+    ImageBufferPool *imageBufferPool;
     QScopedPointer<Filter> filterPtr;
     QSharedPointer<Subtitle> subTitleFramePtr;
     QImage videoImage;
@@ -159,8 +163,7 @@ auto WidgetRender::isSupportedOutput_pix_fmt(AVPixelFormat pix_fmt) -> bool
     return d_ptr->supportFormats.contains(pix_fmt);
 }
 
-auto WidgetRender::convertSupported_pix_fmt(const QSharedPointer<Frame> &framePtr)
-    -> QSharedPointer<Frame>
+auto WidgetRender::convertSupported_pix_fmt(const FramePtr &framePtr) -> FramePtr
 {
     return d_ptr->fliterFrame(framePtr);
 
@@ -211,7 +214,7 @@ void WidgetRender::paintEvent(QPaintEvent *event)
     paintSubTitleFrame(rect, &painter);
 }
 
-void WidgetRender::updateFrame(const QSharedPointer<Frame> &framePtr)
+void WidgetRender::updateFrame(const FramePtr &framePtr)
 {
     QMetaObject::invokeMethod(
         this, [=] { displayFrame(framePtr); }, Qt::QueuedConnection);
@@ -234,7 +237,7 @@ void WidgetRender::updateSubTitleFrame(const QSharedPointer<Subtitle> &framePtr)
         Qt::QueuedConnection);
 }
 
-void WidgetRender::displayFrame(const QSharedPointer<Frame> &framePtr)
+void WidgetRender::displayFrame(const FramePtr &framePtr)
 {
     d_ptr->framePtr = framePtr;
     d_ptr->videoImage = framePtr->toImage();
@@ -14,8 +14,7 @@ public:
     ~WidgetRender() override;
 
     auto isSupportedOutput_pix_fmt(AVPixelFormat pix_fmt) -> bool override;
-    auto convertSupported_pix_fmt(const QSharedPointer<Frame> &framePtr)
-        -> QSharedPointer<Frame> override;
+    auto convertSupported_pix_fmt(const FramePtr &framePtr) -> FramePtr override;
     auto supportedOutput_pix_fmt() -> QVector<AVPixelFormat> override;
 
     void resetAllFrame() override;
@@ -25,11 +24,11 @@ public:
 protected:
     void paintEvent(QPaintEvent *event) override;
 
-    void updateFrame(const QSharedPointer<Frame> &framePtr) override;
+    void updateFrame(const FramePtr &framePtr) override;
     void updateSubTitleFrame(const QSharedPointer<Subtitle> &framePtr) override;
 
 private:
-    void displayFrame(const QSharedPointer<Frame> &framePtr);
+    void displayFrame(const FramePtr &framePtr);
     void paintSubTitleFrame(const QRect &rect, QPainter *painter);
 
     class WidgetRenderPrivate;
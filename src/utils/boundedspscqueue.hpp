@@ -0,0 +1,290 @@
+#pragma once
+
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace Utils {
+
+// timestamp of a queued element that has none
+static constexpr qint64 s_invalidQueueTimestamp = std::numeric_limits<qint64>::min();
+
+// Bounded single-producer/single-consumer ring queue.
+// append/insertHead must only be called from the producer thread, take/clear only from the
+// consumer thread (or from any thread once the other side has stopped).
+// The hot path is lock-free, the mutex is only used to park a thread when the ring is
+// empty (consumer) or full (producer).
+// Besides the element capacity, the queue can be bounded by the total bytes of the queued
+// elements and by the timestamp span between the oldest and the newest queued element.
+// One element is always accepted when the queue is empty, so an oversized element cannot stall
+// the producer forever.
+template<typename T>
+class BoundedSpscQueue
+{
+    Q_DISABLE_COPY_MOVE(BoundedSpscQueue);
+
+public:
+    using ClearCallback = std::function<void(T &)>;
+    using MeasureCallback = std::function<qint64(const T &)>;
+    using NotifyCallback = std::function<void()>;
+
+    explicit BoundedSpscQueue(int maxSize) { setMaxSize(maxSize); }
+
+    void append(const T &x)
+    {
+        T t(x);
+        append(std::move(t));
+    }
+
+    void append(T &&x)
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        while (isFull(tail)) {
+            waitNotFull(tail);
+        }
+        push(tail, std::move(x));
+    }
+
+    // non-blocking, x is left untouched if the queue is full
+    auto tryAppend(T &&x) -> bool
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if (isFull(tail)) {
+            return false;
+        }
+        push(tail, std::move(x));
+        return true;
+    }
+
+    // Only one producer exists, so the head of the ring is only reachable from the producer
+    // when the ring is empty, in that case it is the same as append.
+    void insertHead(const T &x) { append(x); }
+    void insertHead(T &&x) { append(std::move(x)); }
+
+    auto take() -> T
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        while (m_tail.load(std::memory_order_acquire) == head) {
+            waitNotEmpty(head);
+        }
+        return pop(head);
+    }
+
+    // non-blocking, returns false if the queue is empty
+    auto tryTake(T &x) -> bool
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (m_tail.load(std::memory_order_acquire) == head) {
+            return false;
+        }
+        x = pop(head);
+        return true;
+    }
+
+    void clear(ClearCallback callback = nullptr)
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        auto tail = m_tail.load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            auto &slot = m_buffer[head % m_capacity];
+            if (callback) {
+                callback(slot);
+            }
+            release(slot);
+            slot = T();
+        }
+        m_head.store(head, std::memory_order_seq_cst);
+        notify(m_producerWaiting, m_notFull);
+        if (m_takenCallback) {
+            m_takenCallback();
+        }
+    }
+
+    [[nodiscard]] auto empty() const -> bool { return size() == 0; }
+
+    [[nodiscard]] auto full() const -> bool { return isFull(m_tail.load()); }
+
+    [[nodiscard]] auto size() const -> size_t
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    // Not thread safe, the producer and the consumer must both be stopped
+    void setMaxSize(int maxSize)
+    {
+        Q_ASSERT(maxSize > 0);
+        clear();
+        m_capacity = static_cast<size_t>(maxSize);
+        m_buffer = std::vector<T>(m_capacity);
+        m_timestamps = std::vector<std::atomic<qint64>>(m_capacity);
+        m_head.store(0);
+        m_tail.store(0);
+        m_bytes.store(0);
+        m_tailTimestamp.store(s_invalidQueueTimestamp);
+    }
+
+    [[nodiscard]] auto maxSize() const -> size_t { return m_capacity; }
+
+    // Not thread safe, the producer and the consumer must both be stopped
+    // maxBytes <= 0 means unlimited
+    void setByteLimit(qint64 maxBytes, MeasureCallback bytesOf)
+    {
+        m_maxBytes = maxBytes;
+        m_bytesOf = std::move(bytesOf);
+    }
+
+    [[nodiscard]] auto maxBytes() const -> qint64 { return m_maxBytes; }
+
+    [[nodiscard]] auto bytes() const -> qint64 { return m_bytes.load(); }
+
+    // Not thread safe, the producer and the consumer must both be stopped
+    // maxDuration <= 0 means unlimited, timestampOf returns s_invalidQueueTimestamp for elements
+    // without a timestamp
+    void setDurationLimit(qint64 maxDuration, MeasureCallback timestampOf)
+    {
+        m_maxDuration = maxDuration;
+        m_timestampOf = std::move(timestampOf);
+    }
+
+    [[nodiscard]] auto maxDuration() const -> qint64 { return m_maxDuration; }
+
+    // Not thread safe, the producer and the consumer must both be stopped
+    // appendedCallback is called by the producer after every append,
+    // takenCallback by the consumer after every take and clear,
+    // they let an event driven consumer/producer resume without blocking on the queue
+    void setNotifyCallbacks(NotifyCallback appendedCallback, NotifyCallback takenCallback)
+    {
+        m_appendedCallback = std::move(appendedCallback);
+        m_takenCallback = std::move(takenCallback);
+    }
+
+    // timestamp span of the queued elements, 0 if the queue is empty
+    [[nodiscard]] auto duration() const -> qint64
+    {
+        auto head = m_head.load(std::memory_order_acquire);
+        if (m_tail.load(std::memory_order_acquire) == head) {
+            return 0;
+        }
+        auto oldest = m_timestamps[head % m_capacity].load();
+        auto newest = m_tailTimestamp.load();
+        if (oldest == s_invalidQueueTimestamp || newest == s_invalidQueueTimestamp || newest < oldest) {
+            return 0;
+        }
+        return newest - oldest;
+    }
+
+private:
+    void push(size_t tail, T &&x)
+    {
+        auto bytes = m_bytesOf ? m_bytesOf(x) : 0;
+        auto timestamp = m_timestampOf ? m_timestampOf(x) : s_invalidQueueTimestamp;
+        m_buffer[tail % m_capacity] = std::move(x);
+        m_bytes.fetch_add(bytes);
+        if (timestamp != s_invalidQueueTimestamp) {
+            m_tailTimestamp.store(timestamp);
+        }
+        // an element without a timestamp is counted from the newest one before it
+        m_timestamps[tail % m_capacity].store(m_tailTimestamp.load());
+        m_tail.store(tail + 1, std::memory_order_seq_cst);
+        notify(m_consumerWaiting, m_notEmpty);
+        if (m_appendedCallback) {
+            m_appendedCallback();
+        }
+    }
+
+    auto pop(size_t head) -> T
+    {
+        auto &slot = m_buffer[head % m_capacity];
+        T front(std::move(slot));
+        slot = T();
+        release(front);
+        m_head.store(head + 1, std::memory_order_seq_cst);
+        notify(m_producerWaiting, m_notFull);
+        if (m_takenCallback) {
+            m_takenCallback();
+        }
+        return front;
+    }
+
+    [[nodiscard]] auto isFull(size_t tail) const -> bool
+    {
+        auto size = tail - m_head.load();
+        if (size >= m_capacity) {
+            return true;
+        }
+        if (size == 0) {
+            return false;
+        }
+        if (m_maxBytes > 0 && m_bytes.load() >= m_maxBytes) {
+            return true;
+        }
+        return m_maxDuration > 0 && duration() >= m_maxDuration;
+    }
+
+    // consumer side accounting of an element leaving the queue
+    void release(const T &x)
+    {
+        if (m_bytesOf) {
+            m_bytes.fetch_sub(m_bytesOf(x));
+        }
+    }
+
+    void waitNotFull(size_t tail)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_producerWaiting.store(true);
+        while (isFull(tail)) {
+            m_notFull.wait(&m_mutex);
+        }
+        m_producerWaiting.store(false);
+    }
+
+    void waitNotEmpty(size_t head)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_consumerWaiting.store(true);
+        while (m_tail.load() == head) {
+            m_notEmpty.wait(&m_mutex);
+        }
+        m_consumerWaiting.store(false);
+    }
+
+    void notify(const std::atomic_bool &waiting, QWaitCondition &condition)
+    {
+        if (!waiting.load()) {
+            return;
+        }
+        QMutexLocker locker(&m_mutex);
+        condition.wakeOne();
+    }
+
+    static constexpr auto s_cacheLineSize = 64;
+
+    alignas(s_cacheLineSize) std::atomic<size_t> m_head = 0; // written by consumer
+    alignas(s_cacheLineSize) std::atomic<size_t> m_tail = 0; // written by producer
+    alignas(s_cacheLineSize) std::atomic_bool m_consumerWaiting = false;
+    std::atomic_bool m_producerWaiting = false;
+    std::atomic<qint64> m_bytes = 0;
+    std::atomic<qint64> m_tailTimestamp = s_invalidQueueTimestamp; // written by producer
+
+    std::vector<T> m_buffer;
+    // timestamp of each slot, written by the producer before the slot is published
+    std::vector<std::atomic<qint64>> m_timestamps;
+    size_t m_capacity = 0;
+    qint64 m_maxBytes = 0;
+    qint64 m_maxDuration = 0;
+    MeasureCallback m_bytesOf;
+    MeasureCallback m_timestampOf;
+    NotifyCallback m_appendedCallback;
+    NotifyCallback m_takenCallback;
+
+    QMutex m_mutex;
+    QWaitCondition m_notEmpty;
+    QWaitCondition m_notFull;
+};
+
+} // namespace Utils
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace Utils {
+
+template<typename T>
+class Recycler
+{
+public:
+    virtual ~Recycler() = default;
+
+    // takes ownership of t
+    virtual void recycle(T *t) = 0;
+};
+
+// Base of objects shared through IntrusiveRef<T>, the reference count lives in the object
+// itself, so sharing needs no separate control block.
+// The count and the recycler are never copied.
+template<typename T>
+class RefCounted
+{
+public:
+    RefCounted() = default;
+    RefCounted(const RefCounted & /*other*/) {}
+    auto operator=(const RefCounted & /*other*/) -> RefCounted & { return *this; }
+
+    [[nodiscard]] auto refCount() const -> int { return m_refCount.load(); }
+
+protected:
+    ~RefCounted() = default;
+
+private:
+    template<typename>
+    friend class IntrusiveRef;
+    template<typename>
+    friend class ObjectPool;
+
+    mutable std::atomic_int m_refCount = 0;
+    // set by a pool, the object is handed back to it instead of being deleted
+    std::shared_ptr<Recycler<T>> m_recycler;
+};
+
+// Reference counted handle of a RefCounted<T>, API compatible with the parts of QSharedPointer
+// used in this project. Moving a handle never touches the reference count.
+template<typename T>
+class IntrusiveRef
+{
+public:
+    IntrusiveRef() noexcept = default;
+    IntrusiveRef(std::nullptr_t) noexcept {}
+    explicit IntrusiveRef(T *t) noexcept
+        : m_ptr(t)
+    {
+        ref();
+    }
+    IntrusiveRef(const IntrusiveRef &other) noexcept
+        : m_ptr(other.m_ptr)
+    {
+        ref();
+    }
+    IntrusiveRef(IntrusiveRef &&other) noexcept
+        : m_ptr(std::exchange(other.m_ptr, nullptr))
+    {}
+    ~IntrusiveRef() { deref(); }
+
+    auto operator=(const IntrusiveRef &other) noexcept -> IntrusiveRef &
+    {
+        IntrusiveRef(other).swap(*this);
+        return *this;
+    }
+    auto operator=(IntrusiveRef &&other) noexcept -> IntrusiveRef &
+    {
+        IntrusiveRef(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept { IntrusiveRef().swap(*this); }
+    void reset(T *t) noexcept { IntrusiveRef(t).swap(*this); }
+    void swap(IntrusiveRef &other) noexcept { std::swap(m_ptr, other.m_ptr); }
+
+    [[nodiscard]] auto data() const noexcept -> T * { return m_ptr; }
+    [[nodiscard]] auto get() const noexcept -> T * { return m_ptr; }
+    [[nodiscard]] auto isNull() const noexcept -> bool { return m_ptr == nullptr; }
+    [[nodiscard]] auto useCount() const noexcept -> int
+    {
+        return m_ptr != nullptr ? m_ptr->m_refCount.load() : 0;
+    }
+
+    auto operator->() const noexcept -> T * { return m_ptr; }
+    auto operator*() const noexcept -> T & { return *m_ptr; }
+    explicit operator bool() const noexcept { return m_ptr != nullptr; }
+    auto operator!() const noexcept -> bool { return m_ptr == nullptr; }
+
+    friend auto operator==(const IntrusiveRef &lhs, const IntrusiveRef &rhs) noexcept -> bool
+    {
+        return lhs.m_ptr == rhs.m_ptr;
+    }
+    friend auto operator!=(const IntrusiveRef &lhs, const IntrusiveRef &rhs) noexcept -> bool
+    {
+        return lhs.m_ptr != rhs.m_ptr;
+    }
+
+private:
+    void ref() noexcept
+    {
+        if (m_ptr != nullptr) {
+            m_ptr->m_refCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void deref() noexcept
+    {
+        if (m_ptr == nullptr
+            || m_ptr->m_refCount.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        // the recycler may delete the object, so take it out first
+        auto recycler = std::move(m_ptr->m_recycler);
+        if (recycler) {
+            recycler->recycle(m_ptr);
+        } else {
+            delete m_ptr;
+        }
+    }
+
+    T *m_ptr = nullptr;
+};
+
+} // namespace Utils
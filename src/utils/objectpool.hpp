@@ -0,0 +1,113 @@
+#pragma once
+
+#include "intrusiveref.hpp"
+
+#include <QMutex>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Utils {
+
+// Thread safe pool of reusable heap objects, T derives from RefCounted<T>.
+// acquire() hands out an IntrusiveRef, when the last reference drops the object is recycled and
+// put back into the pool instead of being deleted, so a steady state producer/consumer loop stops
+// allocating once the pool is warm. Handles may outlive the pool, they delete their object in
+// that case.
+template<typename T>
+class ObjectPool
+{
+    Q_DISABLE_COPY_MOVE(ObjectPool);
+
+public:
+    using RecycleCallback = std::function<void(T *)>;
+
+    explicit ObjectPool(RecycleCallback recycle = nullptr, int maxCached = 256)
+        : m_state(std::make_shared<State>())
+    {
+        m_state->recycleCallback = std::move(recycle);
+        m_state->maxCached = maxCached;
+    }
+
+    ~ObjectPool()
+    {
+        QMutexLocker locker(&m_state->mutex);
+        m_state->closed = true;
+        for (auto *t : m_state->objects) {
+            delete t;
+        }
+        m_state->objects.clear();
+    }
+
+    auto acquire() -> IntrusiveRef<T>
+    {
+        T *t = nullptr;
+        {
+            QMutexLocker locker(&m_state->mutex);
+            if (!m_state->objects.empty()) {
+                t = m_state->objects.back();
+                m_state->objects.pop_back();
+            }
+        }
+        if (t != nullptr) {
+            m_state->reused.fetch_add(1);
+        } else {
+            t = new T;
+            m_state->created.fetch_add(1);
+        }
+        t->m_recycler = m_state;
+        return IntrusiveRef<T>(t);
+    }
+
+    // Not thread safe, call before handing out objects
+    void setMaxCached(int maxCached) { m_state->maxCached = maxCached; }
+    [[nodiscard]] auto maxCached() const -> int { return m_state->maxCached; }
+
+    // objects allocated because the pool was empty
+    [[nodiscard]] auto createdCount() const -> qint64 { return m_state->created.load(); }
+    // acquire calls served from the pool
+    [[nodiscard]] auto reusedCount() const -> qint64 { return m_state->reused.load(); }
+    [[nodiscard]] auto cachedCount() const -> int
+    {
+        QMutexLocker locker(&m_state->mutex);
+        return static_cast<int>(m_state->objects.size());
+    }
+
+    void resetCounters()
+    {
+        m_state->created.store(0);
+        m_state->reused.store(0);
+    }
+
+private:
+    struct State : public Recycler<T>
+    {
+        void recycle(T *t) override
+        {
+            if (recycleCallback) {
+                recycleCallback(t);
+            }
+            QMutexLocker locker(&mutex);
+            if (closed || static_cast<int>(objects.size()) >= maxCached) {
+                locker.unlock();
+                delete t;
+                return;
+            }
+            objects.push_back(t);
+        }
+
+        mutable QMutex mutex;
+        std::vector<T *> objects;
+        RecycleCallback recycleCallback;
+        int maxCached = 0;
+        bool closed = false;
+        std::atomic<qint64> created = 0;
+        std::atomic<qint64> reused = 0;
+    };
+
+    std::shared_ptr<State> m_state;
+};
+
+} // namespace Utils
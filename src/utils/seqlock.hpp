@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace Utils {
+
+// Sequence lock around a small trivially copyable value.
+// Readers never block the writer and always get a consistent copy, they retry if a store
+// overlapped the read. The value is kept in atomic words, so concurrent access is not a data race.
+// Writers must be serialized by the caller.
+template<typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    Q_DISABLE_COPY_MOVE(SeqLock);
+
+public:
+    explicit SeqLock(const T &value = T()) { store(value); }
+
+    [[nodiscard]] auto load() const -> T
+    {
+        std::array<quint64, s_wordCount> words;
+        while (true) {
+            auto sequence = m_sequence.load(std::memory_order_acquire);
+            if ((sequence & 1) != 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t i = 0; i < s_wordCount; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == sequence) {
+                break;
+            }
+        }
+        T value;
+        std::memcpy(&value, words.data(), sizeof(T));
+        return value;
+    }
+
+    void store(const T &value)
+    {
+        std::array<quint64, s_wordCount> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+        auto sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < s_wordCount; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t s_wordCount = (sizeof(T) + sizeof(quint64) - 1) / sizeof(quint64);
+
+    std::atomic<quint64> m_sequence = 0;
+    std::array<std::atomic<quint64>, s_wordCount> m_words{};
+};
+
+} // namespace Utils
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+namespace Utils {
+
+// Preallocated lock-free single-producer/single-consumer byte ring.
+// The producer fills writeSpan() in place and publishes it with commitWrite(), the consumer
+// drains readSpan() and releases it with commitRead(), so bytes are never moved inside the ring.
+// Spans are contiguous, a region crossing the end of the buffer is handed out in two steps.
+class SpscByteRing
+{
+    Q_DISABLE_COPY_MOVE(SpscByteRing);
+
+public:
+    SpscByteRing() = default;
+    explicit SpscByteRing(qint64 capacity) { reset(capacity); }
+
+    // Not thread safe, the producer and the consumer must both be stopped
+    void reset(qint64 capacity)
+    {
+        Q_ASSERT(capacity >= 0);
+        if (capacity != m_capacity) {
+            m_buffer.reset(capacity > 0 ? new char[capacity] : nullptr);
+            m_capacity = capacity;
+        }
+        m_head.store(0);
+        m_tail.store(0);
+    }
+
+    [[nodiscard]] auto capacity() const -> qint64 { return m_capacity; }
+
+    [[nodiscard]] auto size() const -> qint64
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] auto freeSize() const -> qint64 { return m_capacity - size(); }
+
+    [[nodiscard]] auto empty() const -> bool { return size() == 0; }
+
+    // producer, contiguous writable bytes starting at the returned pointer
+    auto writeSpan(qint64 &size) -> char *
+    {
+        if (m_capacity == 0) {
+            size = 0;
+            return nullptr;
+        }
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        auto head = m_head.load(std::memory_order_acquire);
+        auto offset = tail % m_capacity;
+        size = std::min(m_capacity - (tail - head), m_capacity - offset);
+        return m_buffer.get() + offset;
+    }
+
+    // producer, publishes size bytes of the last writeSpan()
+    void commitWrite(qint64 size)
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        Q_ASSERT(size >= 0 && tail + size - m_head.load() <= m_capacity);
+        m_tail.store(tail + size, std::memory_order_release);
+    }
+
+    // producer, copies as much as fits and returns it
+    auto write(const char *data, qint64 size) -> qint64
+    {
+        qint64 written = 0;
+        while (written < size) {
+            qint64 spanSize = 0;
+            auto *span = writeSpan(spanSize);
+            if (spanSize == 0) {
+                break;
+            }
+            spanSize = std::min(spanSize, size - written);
+            std::memcpy(span, data + written, spanSize);
+            commitWrite(spanSize);
+            written += spanSize;
+        }
+        return written;
+    }
+
+    // consumer, contiguous readable bytes starting at the returned pointer
+    auto readSpan(qint64 &size) const -> const char *
+    {
+        if (m_capacity == 0) {
+            size = 0;
+            return nullptr;
+        }
+        auto head = m_head.load(std::memory_order_relaxed);
+        auto tail = m_tail.load(std::memory_order_acquire);
+        auto offset = head % m_capacity;
+        size = std::min(tail - head, m_capacity - offset);
+        return m_buffer.get() + offset;
+    }
+
+    // consumer, releases size bytes of the last readSpan() to the producer
+    void commitRead(qint64 size)
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        Q_ASSERT(size >= 0 && head + size <= m_tail.load());
+        m_head.store(head + size, std::memory_order_release);
+    }
+
+    // consumer, copies up to maxSize bytes out and returns the count
+    auto read(char *data, qint64 maxSize) -> qint64
+    {
+        qint64 readed = 0;
+        while (readed < maxSize) {
+            qint64 spanSize = 0;
+            const auto *span = readSpan(spanSize);
+            if (spanSize == 0) {
+                break;
+            }
+            spanSize = std::min(spanSize, maxSize - readed);
+            std::memcpy(data + readed, span, spanSize);
+            commitRead(spanSize);
+            readed += spanSize;
+        }
+        return readed;
+    }
+
+    // consumer, drops everything readable
+    void clear()
+    {
+        m_head.store(m_tail.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    static constexpr auto s_cacheLineSize = 64;
+
+    // monotonic byte counters, the offset in the buffer is counter % capacity
+    alignas(s_cacheLineSize) std::atomic<qint64> m_head = 0; // written by consumer
+    alignas(s_cacheLineSize) std::atomic<qint64> m_tail = 0; // written by producer
+
+    std::unique_ptr<char[]> m_buffer;
+    qint64 m_capacity = 0;
+};
+
+} // namespace Utils
@@ -2,6 +2,7 @@
 
 #include <QMutex>
 
+#include <algorithm>
 #include <deque>
 #include <functional>
 
@@ -67,6 +68,17 @@ public:
         }
     }
 
+    // returns the number of elements removed
+    template<typename Predicate>
+    auto removeIf(Predicate predicate) -> int
+    {
+        QMutexLocker locker(&m_mutex);
+        auto iter = std::remove_if(m_queue.begin(), m_queue.end(), predicate);
+        auto count = static_cast<int>(std::distance(iter, m_queue.end()));
+        m_queue.erase(iter, m_queue.end());
+        return count;
+    }
+
     [[nodiscard]] auto size() const -> int
     {
         QMutexLocker locker(&m_mutex);
@@ -15,13 +15,18 @@ SOURCES += \
 
 HEADERS += \
     boundedblockingqueue.hpp \
+    boundedspscqueue.hpp \
     countdownlatch.hpp \
     fps.hpp \
     hostosinfo.h \
+    intrusiveref.hpp \
     logasync.h \
+    objectpool.hpp \
     osspecificaspects.h \
     range.hpp \
+    seqlock.hpp \
     singleton.hpp \
+    spscbytering.hpp \
     speed.hpp \
     threadsafequeue.hpp \
     utils_global.h \
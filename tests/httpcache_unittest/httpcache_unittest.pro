@@ -0,0 +1,24 @@
+include(../../common.pri)
+
+QT       += core network
+
+CONFIG += console
+
+TEMPLATE = app
+
+TARGET = httpcache_unittest
+
+LIBS += -L$$APP_OUTPUT_PATH/../libs \
+    -l$$replaceLibName(ffmpeg) \
+    -l$$replaceLibName(utils)
+
+include(../../src/3rdparty/3rdparty.pri)
+
+SOURCES += \
+    httpserverthread.cc \
+    main.cc
+
+HEADERS += \
+    httpserverthread.hpp
+
+DESTDIR = $$APP_OUTPUT_PATH
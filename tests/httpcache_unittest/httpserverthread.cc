@@ -0,0 +1,157 @@
+#include "httpserverthread.hpp"
+
+#include <QHash>
+#include <QSemaphore>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <atomic>
+
+class HttpServerThread::HttpServerThreadPrivate
+{
+public:
+    explicit HttpServerThreadPrivate(HttpServerThread *q)
+        : q_ptr(q)
+    {}
+
+    void handle(QTcpSocket *socket)
+    {
+        auto request = socket->property("request").toByteArray() + socket->readAll();
+        if (!request.contains("\r\n\r\n")) {
+            socket->setProperty("request", request);
+            return;
+        }
+        auto lines = request.left(request.indexOf("\r\n\r\n")).split('\n');
+        auto requestLine = lines.takeFirst().trimmed().split(' ');
+        if (requestLine.size() < 2) {
+            respond(socket, "400 Bad Request", {}, {});
+            return;
+        }
+        const auto &method = requestLine.at(0);
+        const auto &path = requestLine.at(1);
+        if (!files.contains(path)) {
+            respond(socket, "404 Not Found", {}, {});
+            return;
+        }
+        const auto &data = files.value(path);
+        qint64 start = 0;
+        qint64 end = data.size() - 1;
+        auto ranged = false;
+        for (const auto &line : std::as_const(lines)) {
+            auto header = line.trimmed();
+            if (!header.toLower().startsWith("range: bytes=")) {
+                continue;
+            }
+            auto range = header.mid(header.indexOf('=') + 1).split('-');
+            start = range.value(0).toLongLong();
+            if (!range.value(1).isEmpty()) {
+                end = qMin(end, range.value(1).toLongLong());
+            }
+            ranged = true;
+        }
+        if (start > end) {
+            respond(socket,
+                    "416 Range Not Satisfiable",
+                    "Content-Range: bytes */" + QByteArray::number(data.size()) + "\r\n",
+                    {});
+            return;
+        }
+        if (method == "GET") {
+            requestCount.fetch_add(1);
+        }
+        QByteArray headers = "Accept-Ranges: bytes\r\n";
+        if (ranged) {
+            headers += "Content-Range: bytes " + QByteArray::number(start) + "-"
+                       + QByteArray::number(end) + "/" + QByteArray::number(data.size())
+                       + "\r\n";
+        }
+        auto body = data.mid(start, end - start + 1);
+        headers += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+        respond(socket,
+                ranged ? "206 Partial Content" : "200 OK",
+                headers,
+                method == "HEAD" ? QByteArray() : body);
+    }
+
+    static void respond(QTcpSocket *socket,
+                        const QByteArray &status,
+                        const QByteArray &headers,
+                        const QByteArray &body)
+    {
+        QByteArray response = "HTTP/1.1 " + status + "\r\n" + headers;
+        if (!headers.contains("Content-Length")) {
+            response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+        }
+        response += "Connection: close\r\n\r\n" + body;
+        socket->write(response);
+        socket->disconnectFromHost();
+    }
+
+    HttpServerThread *q_ptr;
+
+    QHash<QByteArray, QByteArray> files;
+    quint16 port = 0;
+    std::atomic_int requestCount = 0;
+    QSemaphore listening;
+};
+
+HttpServerThread::HttpServerThread(QObject *parent)
+    : QThread{parent}
+    , d_ptr(new HttpServerThreadPrivate(this))
+{}
+
+HttpServerThread::~HttpServerThread()
+{
+    stopServer();
+}
+
+void HttpServerThread::addFile(const QString &path, const QByteArray &data)
+{
+    d_ptr->files.insert(path.toUtf8(), data);
+}
+
+auto HttpServerThread::startServer() -> bool
+{
+    stopServer();
+    start();
+    d_ptr->listening.acquire();
+    return d_ptr->port != 0;
+}
+
+void HttpServerThread::stopServer()
+{
+    if (isRunning()) {
+        quit();
+        wait();
+    }
+}
+
+auto HttpServerThread::url(const QString &path) const -> QByteArray
+{
+    return "http://127.0.0.1:" + QByteArray::number(d_ptr->port) + path.toUtf8();
+}
+
+auto HttpServerThread::requestCount() const -> int
+{
+    return d_ptr->requestCount.load();
+}
+
+void HttpServerThread::run()
+{
+    QTcpServer server;
+    d_ptr->port = server.listen(QHostAddress::LocalHost) ? server.serverPort() : 0;
+    d_ptr->listening.release();
+    if (d_ptr->port == 0) {
+        qWarning() << server.errorString();
+        return;
+    }
+    connect(&server, &QTcpServer::newConnection, &server, [&] {
+        while (auto *socket = server.nextPendingConnection()) {
+            connect(socket, &QTcpSocket::readyRead, socket, [this, socket] {
+                d_ptr->handle(socket);
+            });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    });
+    exec();
+}
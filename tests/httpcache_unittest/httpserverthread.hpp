@@ -0,0 +1,33 @@
+#ifndef HTTPSERVERTHREAD_HPP
+#define HTTPSERVERTHREAD_HPP
+
+#include <QThread>
+
+// Minimal http/1.1 server on 127.0.0.1 answering GET and HEAD, with range requests, for files
+// held in memory. One request per connection.
+class HttpServerThread : public QThread
+{
+    Q_OBJECT
+public:
+    explicit HttpServerThread(QObject *parent = nullptr);
+    ~HttpServerThread() override;
+
+    // before startServer
+    void addFile(const QString &path, const QByteArray &data);
+
+    auto startServer() -> bool;
+    void stopServer();
+
+    [[nodiscard]] auto url(const QString &path) const -> QByteArray;
+    // GET requests served so far
+    [[nodiscard]] auto requestCount() const -> int;
+
+protected:
+    void run() override;
+
+private:
+    class HttpServerThreadPrivate;
+    QScopedPointer<HttpServerThreadPrivate> d_ptr;
+};
+
+#endif // HTTPSERVERTHREAD_HPP
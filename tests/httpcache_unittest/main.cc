@@ -0,0 +1,140 @@
+// Serves files over http on the loopback and reads them through HttpCacheIO. Checks that a
+// second open and seeks into fetched ranges are served from the cache without new requests,
+// and that the least recently used entries are evicted over the cache budget.
+
+#include "httpserverthread.hpp"
+
+#include <ffmpeg/httpcacheio.hpp>
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+#define CHECK(condition) \
+    if (!(condition)) { \
+        qWarning() << "Check failed:" << #condition << "line" << __LINE__; \
+        return 1; \
+    }
+
+static constexpr qint64 s_fileSize = 4 * 1024 * 1024;
+// reads are at least this far inside a fetched range, the avio buffer reads ahead
+static constexpr qint64 s_margin = 256 * 1024;
+
+static auto cacheDirectory() -> QString
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/http";
+}
+
+// the entry key of HttpCacheIO
+static auto dataPath(const QByteArray &url, qint64 length) -> QString
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(url);
+    hash.addData(QByteArray::number(length));
+    return cacheDirectory() + "/" + QString::fromLatin1(hash.result().toHex()) + ".data";
+}
+
+static auto randomData(quint32 seed) -> QByteArray
+{
+    QRandomGenerator generator(seed);
+    QByteArray data(s_fileSize, Qt::Uninitialized);
+    generator.fillRange(reinterpret_cast<quint32 *>(data.data()), s_fileSize / sizeof(quint32));
+    return data;
+}
+
+static auto readRange(Ffmpeg::HttpCacheIO &io, qint64 start, qint64 end) -> QByteArray
+{
+    auto *avioContext = io.avioContext();
+    if (avio_seek(avioContext, start, SEEK_SET) != start) {
+        return {};
+    }
+    QByteArray data(end - start, Qt::Uninitialized);
+    auto ret = avio_read(avioContext, reinterpret_cast<unsigned char *>(data.data()), data.size());
+    return ret == data.size() ? data : QByteArray();
+}
+
+static auto readAll(const QByteArray &url) -> QByteArray
+{
+    Ffmpeg::HttpCacheIO io;
+    return io.open(url) ? readRange(io, 0, s_fileSize) : QByteArray();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    a.setApplicationName("httpcache_unittest");
+    QDir(cacheDirectory()).removeRecursively();
+    avformat_network_init();
+
+    QMap<QString, QByteArray> files{{"/a.bin", randomData(1)},
+                                    {"/b.bin", randomData(2)},
+                                    {"/c.bin", randomData(3)}};
+    HttpServerThread server;
+    for (auto iter = files.cbegin(); iter != files.cend(); ++iter) {
+        server.addFile(iter.key(), iter.value());
+    }
+    CHECK(server.startServer());
+    const auto &dataA = files.value("/a.bin");
+    auto urlA = server.url("/a.bin");
+
+    // first open fetches the first half and the last quarter
+    {
+        Ffmpeg::HttpCacheIO io;
+        CHECK(io.open(urlA));
+        CHECK(readRange(io, 0, s_fileSize / 2) == dataA.mid(0, s_fileSize / 2));
+        CHECK(readRange(io, s_fileSize * 3 / 4, s_fileSize) == dataA.mid(s_fileSize * 3 / 4));
+    }
+    CHECK(QFile::exists(dataPath(urlA, s_fileSize)));
+
+    // second open, seeks into the fetched ranges are read from the cache only
+    {
+        Ffmpeg::HttpCacheIO io;
+        CHECK(io.open(urlA));
+        CHECK(io.cachedBytes() >= s_fileSize * 3 / 4);
+        auto requestCount = server.requestCount();
+        auto start = s_fileSize / 4;
+        auto end = s_fileSize / 2 - s_margin;
+        CHECK(readRange(io, start, end) == dataA.mid(start, end - start));
+        start = s_fileSize * 7 / 8;
+        CHECK(readRange(io, start, s_fileSize) == dataA.mid(start));
+        CHECK(readRange(io, 0, s_margin) == dataA.mid(0, s_margin));
+        CHECK(server.requestCount() == requestCount);
+
+        // the gap is fetched and cached
+        start = s_fileSize / 2 + s_margin;
+        end = s_fileSize * 3 / 4 - s_margin;
+        CHECK(readRange(io, start, end) == dataA.mid(start, end - start));
+        CHECK(server.requestCount() > requestCount);
+    }
+
+    // a is used before b, with room for two entries c evicts the least recently used a
+    CHECK(readAll(urlA) == dataA);
+    QThread::msleep(100);
+    auto urlB = server.url("/b.bin");
+    CHECK(readAll(urlB) == files.value("/b.bin"));
+    QThread::msleep(100);
+    Ffmpeg::HttpCacheIO::setCacheBudget(s_fileSize * 5 / 2);
+    CHECK(QFile::exists(dataPath(urlA, s_fileSize)));
+    CHECK(QFile::exists(dataPath(urlB, s_fileSize)));
+    auto urlC = server.url("/c.bin");
+    CHECK(readAll(urlC) == files.value("/c.bin"));
+    CHECK(!QFile::exists(dataPath(urlA, s_fileSize)));
+    CHECK(QFile::exists(dataPath(urlB, s_fileSize)));
+    CHECK(QFile::exists(dataPath(urlC, s_fileSize)));
+
+    // a smaller budget evicts down to it
+    Ffmpeg::HttpCacheIO::setCacheBudget(s_fileSize);
+    CHECK(!QFile::exists(dataPath(urlB, s_fileSize)));
+    CHECK(QFile::exists(dataPath(urlC, s_fileSize)));
+
+    server.stopServer();
+    QDir(cacheDirectory()).removeRecursively();
+    qInfo() << "All checks passed";
+    return 0;
+}
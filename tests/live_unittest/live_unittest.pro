@@ -0,0 +1,20 @@
+include(../../common.pri)
+
+QT       += core gui network multimedia openglwidgets core5compat
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TEMPLATE = app
+
+TARGET = live_unittest
+
+LIBS += -L$$APP_OUTPUT_PATH/../libs \
+    -l$$replaceLibName(ffmpeg) \
+    -l$$replaceLibName(utils)
+
+include(../../src/3rdparty/3rdparty.pri)
+
+SOURCES += \
+    main.cc
+
+DESTDIR = $$APP_OUTPUT_PATH
@@ -0,0 +1,131 @@
+// Plays a stream served by the ffmpeg command line tool over udp on the loopback in live mode.
+// Passes when playback starts and the last reported latency is under the threshold, drops to
+// the newest packets included.
+//
+// live_unittest [--ffmpeg <path>] [--port <port>] [--seconds <n>] [--threshold <ms>]
+
+#include <ffmpeg/event/valueevent.hpp>
+#include <ffmpeg/player.h>
+#include <utils/logasync.h>
+#include <utils/utils.h>
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QProcess>
+#include <QTimer>
+
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/avutil.h>
+}
+
+int main(int argc, char *argv[])
+{
+    Utils::setHighDpiEnvironmentVariable();
+
+    QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption ffmpegOption("ffmpeg", "ffmpeg executable", "path", "ffmpeg");
+    QCommandLineOption portOption("port", "udp port on the loopback", "port", "23000");
+    QCommandLineOption secondsOption("seconds", "playback time", "n", "20");
+    QCommandLineOption thresholdOption("threshold", "live latency threshold", "ms", "300");
+    parser.addOptions({ffmpegOption, portOption, secondsOption, thresholdOption});
+    parser.process(a);
+
+    Utils::LogAsync *log = Utils::LogAsync::instance();
+    log->setOrientation(Utils::LogAsync::Orientation::Std);
+    log->setLogLevel(QtInfoMsg);
+    log->startWork();
+
+    auto url = QString("udp://127.0.0.1:%1").arg(parser.value(portOption));
+    qint64 threshold = parser.value(thresholdOption).toLongLong() * 1000;
+
+    Ffmpeg::Player player;
+    player.setLiveMode(true);
+    player.setLiveLatencyThreshold(threshold);
+
+    auto playing = false;
+    QList<qint64> latencies;
+    QObject::connect(&player, &Ffmpeg::Player::eventIncrease, &a, [&] {
+        while (player.propertyChangeEventSize() > 0) {
+            auto eventPtr = player.takePropertyChangeEvent();
+            switch (eventPtr->type()) {
+            case Ffmpeg::PropertyChangeEvent::EventType::MediaState: {
+                auto *stateEvent = dynamic_cast<Ffmpeg::MediaStateEvent *>(eventPtr.data());
+                playing |= stateEvent->state() == Ffmpeg::MediaState::Playing;
+            } break;
+            case Ffmpeg::PropertyChangeEvent::EventType::LiveLatency: {
+                auto *latencyEvent = dynamic_cast<Ffmpeg::LiveLatencyEvent *>(eventPtr.data());
+                latencies.append(latencyEvent->latency());
+                qInfo() << "Live latency:" << latencyEvent->latency() / 1000 << "ms"
+                        << (latencyEvent->isGlassToGlass() ? "from capture" : "from reception");
+            } break;
+            default: break;
+            }
+        }
+    });
+
+    // the player listens before the stream starts, nothing is lost while probing
+    player.addEvent(Ffmpeg::EventPtr(new Ffmpeg::OpenMediaEvent(url)));
+
+    QProcess server;
+    server.setProcessChannelMode(QProcess::ForwardedChannels);
+    server.start(parser.value(ffmpegOption),
+                 {"-hide_banner",
+                  "-loglevel",
+                  "error",
+                  "-re",
+                  "-f",
+                  "lavfi",
+                  "-i",
+                  "testsrc2=size=1280x720:rate=30",
+                  "-f",
+                  "lavfi",
+                  "-i",
+                  "sine=frequency=440:sample_rate=48000",
+                  "-c:v",
+                  "libx264",
+                  "-preset",
+                  "ultrafast",
+                  "-tune",
+                  "zerolatency",
+                  "-g",
+                  "30",
+                  "-c:a",
+                  "aac",
+                  "-f",
+                  "mpegts",
+                  url + "?pkt_size=1316"});
+    if (!server.waitForStarted()) {
+        qWarning() << "Start ffmpeg failed:" << server.errorString();
+        return 1;
+    }
+
+    auto ret = 1;
+    QTimer::singleShot(parser.value(secondsOption).toInt() * 1000, &a, [&] {
+        if (!playing) {
+            qWarning() << "Playback never started";
+        } else if (latencies.isEmpty()) {
+            qWarning() << "No live latency reported";
+        } else if (latencies.last() > threshold) {
+            qWarning() << "Live latency over the threshold:" << latencies.last() / 1000 << "ms";
+        } else {
+            qInfo() << "Live latency max:"
+                    << *std::max_element(latencies.cbegin(), latencies.cend()) / 1000 << "ms"
+                    << "last:" << latencies.last() / 1000 << "ms";
+            ret = 0;
+        }
+        a.quit();
+    });
+    a.exec();
+
+    player.addEvent(Ffmpeg::EventPtr(new Ffmpeg::CloseMediaEvent));
+    server.kill();
+    server.waitForFinished();
+    log->stop();
+
+    return ret;
+}
@@ -0,0 +1,79 @@
+// Replays a cached seek over video and subtitle packets the way the player does. The subtitle
+// decoder reads the timestamps of packets the cache still holds, so they must come back in
+// stream time base and give the same microseconds on every replay.
+
+#include <ffmpeg/ffmpegutils.hpp>
+#include <ffmpeg/packetcache.hpp>
+
+#include <QCoreApplication>
+
+extern "C" {
+#include <libavcodec/packet.h>
+#include <libavutil/avutil.h>
+}
+
+#define CHECK(condition) \
+    if (!(condition)) { \
+        qWarning() << "Check failed:" << #condition << "line" << __LINE__; \
+        return 1; \
+    }
+
+static constexpr AVRational s_videoTimeBase{1, 90000};
+static constexpr AVRational s_subtitleTimeBase{1, 1000};
+static constexpr auto s_videoIndex = 0;
+static constexpr auto s_subtitleIndex = 1;
+
+static auto makePacket(int streamIndex, qint64 pts, qint64 duration, bool key)
+    -> Ffmpeg::PacketPtr
+{
+    Ffmpeg::PacketPtr packetPtr(new Ffmpeg::Packet);
+    auto *avPacket = packetPtr->avPacket();
+    avPacket->stream_index = streamIndex;
+    avPacket->pts = avPacket->dts = pts;
+    avPacket->duration = duration;
+    avPacket->flags = key ? AV_PKT_FLAG_KEY : 0;
+    return packetPtr;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    // 10 seconds of 25 fps video with a keyframe every second, a subtitle every 2 seconds
+    Ffmpeg::PacketCache packetCache;
+    QMap<qint64, qint64> subtitleTimestamps; // stream time base pts -> microseconds
+    for (int i = 0; i < 250; ++i) {
+        auto videoPtr = makePacket(s_videoIndex, i * 3600, 3600, i % 25 == 0);
+        packetCache.append(videoPtr, s_videoTimeBase, videoPtr->isKey());
+        if (i % 50 == 10) {
+            auto pts = i * 40;
+            auto subtitlePtr = makePacket(s_subtitleIndex, pts, 1500, true);
+            packetCache.append(subtitlePtr, s_subtitleTimeBase, false);
+            subtitleTimestamps.insert(pts, pts * 1000);
+        }
+    }
+
+    for (auto position : {qint64(3500000), qint64(1000000), qint64(7200000)}) {
+        CHECK(packetCache.seek(position));
+        Ffmpeg::PacketPtr packetPtr;
+        auto subtitles = 0;
+        while (packetCache.takeReplay(packetPtr)) {
+            auto *avPacket = packetPtr->avPacket();
+            if (avPacket->stream_index != s_subtitleIndex) {
+                continue;
+            }
+            // what the subtitle decoder shows it at
+            CHECK(subtitleTimestamps.contains(avPacket->pts));
+            CHECK(Ffmpeg::rescaleToMicroseconds(avPacket->pts, s_subtitleTimeBase)
+                  == subtitleTimestamps.value(avPacket->pts));
+            CHECK(Ffmpeg::rescaleToMicroseconds(avPacket->duration, s_subtitleTimeBase)
+                  == 1500000);
+            subtitles++;
+        }
+        CHECK(subtitles > 0);
+    }
+    CHECK(Ffmpeg::rescaleToMicroseconds(AV_NOPTS_VALUE, s_subtitleTimeBase) == AV_NOPTS_VALUE);
+
+    qInfo() << "All checks passed";
+    return 0;
+}
@@ -0,0 +1,20 @@
+include(../../common.pri)
+
+QT       += core
+
+CONFIG += console
+
+TEMPLATE = app
+
+TARGET = packetcache_unittest
+
+LIBS += -L$$APP_OUTPUT_PATH/../libs \
+    -l$$replaceLibName(ffmpeg) \
+    -l$$replaceLibName(utils)
+
+include(../../src/3rdparty/3rdparty.pri)
+
+SOURCES += \
+    main.cc
+
+DESTDIR = $$APP_OUTPUT_PATH
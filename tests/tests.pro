@@ -2,4 +2,7 @@ TEMPLATE = subdirs
 CONFIG += ordered
 
 SUBDIRS += \
+    httpcache_unittest \
+    live_unittest \
+    packetcache_unittest \
     subtitle_unittest